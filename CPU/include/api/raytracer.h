@@ -0,0 +1,130 @@
+#ifndef RAYTRACER_API_H
+#define RAYTRACER_API_H
+
+/*
+ * C interface to the renderer, for embedding it in other programs.
+ *
+ * A scene is either one of the built-in scenes or assembled from materials
+ * and primitives. It is built once into an acceleration structure and can
+ * then be rendered any number of times, whole or by region, into buffers
+ * owned by the caller. Functions report failures through rt_status and
+ * rt_last_error(); no C++ exception crosses this interface.
+ *
+ * A scene may be rendered from several threads at once once it is built,
+ * but must not be modified or destroyed while a render is running.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RT_API_VERSION 1
+
+typedef struct rt_scene rt_scene;
+
+typedef enum rt_status {
+    RT_OK = 0,
+    RT_ERROR_INVALID_ARGUMENT = 1,  /* Bad handle, index or parameter value */
+    RT_ERROR_INVALID_STATE = 2,     /* E.g. editing a built scene, rendering an unbuilt one */
+    RT_ERROR_CANCELLED = 3,         /* The cancel callback asked to stop */
+    RT_ERROR_INTERNAL = 4           /* Unexpected failure, see rt_last_error() */
+} rt_status;
+
+typedef enum rt_accelerator {
+    RT_ACCELERATOR_LIST = 0,
+    RT_ACCELERATOR_KDTREE = 1,
+    RT_ACCELERATOR_GRID = 2,
+    RT_ACCELERATOR_KDTREE_QUANTIZED16 = 3,  /* Kd-tree with 16-bit child bounds */
+    RT_ACCELERATOR_KDTREE_QUANTIZED8 = 4    /* Kd-tree with 8-bit child bounds */
+} rt_accelerator;
+
+typedef enum rt_pixel_format {
+    RT_PIXEL_RGB8 = 0,      /* 3 bytes per pixel, gamma-corrected and clamped */
+    RT_PIXEL_RGB_FLOAT = 1  /* 3 floats per pixel, linear radiance */
+} rt_pixel_format;
+
+typedef struct rt_camera {
+    float position[3];
+    float target[3];
+    float up[3];
+    float fov_degrees;       /* Vertical field of view */
+} rt_camera;
+
+typedef struct rt_render_settings {
+    int image_width;         /* Size of the whole image the region is cut from */
+    int image_height;
+    int samples_per_pixel;
+    int max_depth;           /* Path length limit */
+    uint32_t seed;           /* Equal seeds give equal images */
+    int threads;             /* 0 = one per hardware thread */
+} rt_render_settings;
+
+/* Rectangle of pixels, rows counted from the top of the image */
+typedef struct rt_region {
+    int x, y, width, height;
+} rt_region;
+
+/* Called after each finished tile with the fraction of the region done.
+ * Calls come from rendering threads, one at a time. */
+typedef void (*rt_progress_fn)(float fraction_done, void* user_data);
+
+/* Polled before each tile; return nonzero to stop the render */
+typedef int (*rt_cancel_fn)(void* user_data);
+
+uint32_t rt_api_version(void);
+
+/* Message for the last failed call on this thread, or "" */
+const char* rt_last_error(void);
+
+/* An empty scene with a sky background and a camera at the origin looking
+ * down -z, or a copy of a built-in scene ("simple", "complex", "instanced",
+ * "lights", "field"). Return NULL on failure. */
+rt_scene* rt_scene_create(void);
+rt_scene* rt_scene_create_builtin(const char* name);
+void rt_scene_destroy(rt_scene* scene);
+
+/* Materials are referred to by the index returned in *material_id */
+rt_status rt_scene_add_lambertian(rt_scene* scene, float r, float g, float b, int* material_id);
+rt_status rt_scene_add_diffuse_light(rt_scene* scene, float r, float g, float b, int* material_id);
+
+rt_status rt_scene_add_sphere(rt_scene* scene, float x, float y, float z, float radius, int material_id);
+rt_status rt_scene_add_plane(rt_scene* scene, const float point[3], const float normal[3], int material_id);
+
+/* The scene's own image size, sample count and path depth (400x225, 100 spp
+ * and depth 50 for scenes built through this API), with seed 0 and all
+ * hardware threads */
+rt_status rt_scene_default_settings(const rt_scene* scene, rt_render_settings* settings);
+
+rt_status rt_scene_set_camera(rt_scene* scene, const rt_camera* camera);
+rt_status rt_scene_get_camera(const rt_scene* scene, rt_camera* camera);
+
+/* Sky gradient when sky is nonzero, otherwise a constant color */
+rt_status rt_scene_set_background(rt_scene* scene, int sky, float r, float g, float b);
+
+/* Create the primitives and build the accelerator; the scene can no longer
+ * be edited afterwards */
+rt_status rt_scene_build(rt_scene* scene, rt_accelerator accelerator);
+
+/* Render a region of the image into pixels, which holds region->height rows
+ * of row_stride bytes each. A NULL region means the whole image. progress,
+ * cancel and user_data may be NULL. On cancellation only the tiles finished
+ * so far are written; the rest of the buffer is left untouched. Worker
+ * threads are kept between calls and reused by later renders. */
+rt_status rt_render(const rt_scene* scene,
+                    const rt_render_settings* settings,
+                    const rt_region* region,
+                    rt_pixel_format format,
+                    void* pixels,
+                    size_t row_stride,
+                    rt_progress_fn progress,
+                    rt_cancel_fn cancel,
+                    void* user_data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -4,6 +4,7 @@
 // Forward declaration
 class Material;
 class Ray;
+class Hittable;
 
 struct HitRecord {
     Point3 point;           // Where the ray hit
@@ -11,6 +12,7 @@ struct HitRecord {
     float t;               // Distance along ray
     bool front_face;       // Did ray hit from outside?
     Material* material;    // What material was hit
+    const Hittable* object; // Which primitive was hit (identifies lights)
     
     void set_face_normal(const Ray& ray, const Vec3& outward_normal);
 };
\ No newline at end of file
@@ -3,11 +3,37 @@
 #include "geometry/bounding_box.h"
 
 class Ray;
+class Hittable;
+class Instance;
+
+// Result of a closest-hit traversal: just enough to finish the hit later.
+// One level of instancing is recorded, which is all the scenes use.
+struct Intersection {
+    float t;                            // Distance along the ray
+    const Hittable* primitive = nullptr; // Primitive that was hit, in its own space
+    const Instance* instance = nullptr;  // Instance the primitive was reached through, if any
+};
 
 // Abstract base class for anything that can be hit by a ray
 class Hittable {
 public:
     virtual ~Hittable() = default;
-    virtual bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const = 0;
+    
+    // Closest hit with a full surface interaction. Traversal only tracks
+    // (t, primitive) and the HitRecord is filled once, for the final hit.
+    bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const;
+    
+    // Closest-hit traversal without building a HitRecord
+    virtual bool intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const = 0;
+    
+    // Fill rec for an intersection this object reported. Called on the
+    // instance if there is one, otherwise on the primitive; aggregates never
+    // appear in an Intersection and keep the empty default.
+    virtual void surface_interaction(const Ray& ray, const Intersection& isect, HitRecord& rec) const;
+    
+    // Any-hit query: true if anything intersects the ray within (t_min, t_max).
+    // May stop at the first intersection found and fills no HitRecord.
+    virtual bool occluded(const Ray& ray, float t_min, float t_max) const = 0;
+    
     virtual BoundingBox bounding_box() const = 0;
-};
\ No newline at end of file
+};
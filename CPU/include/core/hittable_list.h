@@ -3,14 +3,21 @@
 #include <vector>
 #include <memory>
 
-// Simple list of hittable objects (we'll replace this with kd-tree later)
+// Simple list of hittable objects. Bounding boxes are kept as coordinate
+// arrays and culled with the SIMD ray-box kernel before objects are tested.
 class HittableList : public Hittable {
 public:
-    std::vector<std::shared_ptr<Hittable>> objects;
+    std::vector<std::shared_ptr<Hittable>> objects;  // Modify through add() and clear() only
     
     void add(std::shared_ptr<Hittable> object);
     void clear();
     
-    bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const override;
+    bool intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const override;
+    bool occluded(const Ray& ray, float t_min, float t_max) const override;
     BoundingBox bounding_box() const override;
+    
+private:
+    static const size_t BATCH = 64;  // Boxes culled per kernel call
+    
+    std::vector<float> bounds[6];    // min x/y/z, max x/y/z of each object's box
 };
\ No newline at end of file
@@ -1,14 +1,22 @@
 #pragma once
 #include "core/hittable.h"
+#include "geometry/sphere_packet.h"
+#include <cstdint>
 #include <vector>
 #include <memory>
 
-// KD-Tree node structure
+class SceneArena;
+class Sphere;
+
+// KD-Tree node structure. Nodes live in an arena and are never destroyed
+// individually, so everything they point to is arena memory too.
 struct KDNode {
-    BoundingBox bbox;                                    // Bounding box for this node
-    std::vector<std::shared_ptr<Hittable>> objects;    // Objects stored in leaf nodes
-    std::unique_ptr<KDNode> left;                       // Left child
-    std::unique_ptr<KDNode> right;                      // Right child
+    BoundingBox bbox;                                   // Bounding box for this node
+    const Hittable* const* objects;                     // Non-sphere objects stored in leaf nodes
+    int object_count;
+    SpherePacket spheres;                               // Spheres stored in leaf nodes, tested with SIMD
+    KDNode* left;                                       // Left child
+    KDNode* right;                                      // Right child
     int axis;                                           // Split axis (0=x, 1=y, 2=z)
     float split_pos;                                    // Position of the split
     bool is_leaf;                                       // Whether this is a leaf node
@@ -16,14 +24,44 @@ struct KDNode {
     KDNode();
 };
 
+// How a built tree stores its nodes
+enum class KDNodeFormat {
+    Full,         // KDNode with a full-precision box per node
+    Quantized16,  // QuantizedKDNode<uint16_t>: child boxes in 1/65535ths of the parent
+    Quantized8    // QuantizedKDNode<uint8_t>: child boxes in 1/255ths of the parent
+};
+
+// Leaf contents of a quantized tree
+struct KDLeaf {
+    const Hittable* const* objects;
+    int object_count;
+    SpherePacket spheres;
+};
+
+// Interior node of a quantized tree. Each child's box is stored as integer
+// steps across this node's own box, rounded outward, so a decoded child box
+// always encloses the exact one. Boxes are decoded top-down during traversal
+// starting from the full-precision root box.
+template <typename Q>
+struct QuantizedKDNode {
+    Q lo[2][3];           // [child][axis] min, in steps up from this box's min
+    Q hi[2][3];           // [child][axis] max, in steps up from this box's min
+    uint32_t child[2];    // Index of an interior node, or LEAF_FLAG | index of a leaf
+    
+    static const uint32_t LEAF_FLAG = 0x80000000u;
+};
+
 // KD-Tree acceleration structure
 class KDTree : public Hittable {
 public:
-    KDTree();
-    ~KDTree() = default;
+    explicit KDTree(KDNodeFormat format = KDNodeFormat::Full);
+    ~KDTree();
     
-    // Build the kd-tree from a list of objects
-    void build(const std::vector<std::shared_ptr<Hittable>>& objects);
+    // Build the kd-tree from a list of objects. Nodes are placed in
+    // target_arena, which must outlive the tree, or in an arena of the tree's
+    // own when none is given. Unless quiet, a summary goes to stderr.
+    void build(const std::vector<std::shared_ptr<Hittable>>& objects, SceneArena* target_arena = nullptr,
+               bool quiet = false);
     
     // Add a single object (rebuilds the tree)
     void add(std::shared_ptr<Hittable> object);
@@ -32,46 +70,92 @@ public:
     void clear();
     
     // Hittable interface
-    bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const override;
+    bool intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const override;
+    bool occluded(const Ray& ray, float t_min, float t_max) const override;
     BoundingBox bounding_box() const override;
     
     // Statistics
     int get_node_count() const;
     int get_max_depth() const;
-    
+    size_t get_node_bytes() const;  // Memory held by nodes and leaf records, excluding leaf contents
+
 private:
-    std::unique_ptr<KDNode> root;
+    KDNodeFormat format;                     // Requested; a build over unbounded objects uses Full
+    KDNode* root;                            // Full format only
+    BoundingBox bounds;                      // Box of the whole tree
+    int node_count;
+    int max_depth;
+    SceneArena* arena;                       // Where nodes and leaf contents are allocated
+    SceneArena* node_arena;                  // Where KDNodes are allocated while building
+    std::unique_ptr<SceneArena> own_arena;   // Set when no arena was supplied
+    
+    // Quantized formats only; the node array matching the format is set
+    const QuantizedKDNode<uint16_t>* nodes16;
+    const QuantizedKDNode<uint8_t>* nodes8;
+    const KDLeaf* leaves;
+    uint32_t root_ref;                       // Node or leaf reference, as in QuantizedKDNode::child
+    int interior_count;
+    int leaf_count;
     std::vector<std::shared_ptr<Hittable>> all_objects;
     
+    // Object with its box and centroid, computed once per build
+    struct BuildItem {
+        const Hittable* object;
+        BoundingBox bbox;
+        Point3 centroid;
+    };
+    
+    // Buffers reused across the whole build so nodes cost no heap allocations
+    struct BuildScratch {
+        std::vector<float> split_values;
+        std::vector<const Sphere*> spheres;
+        std::vector<const Hittable*> others;
+    };
+    
     // Construction parameters
     static const int MAX_DEPTH = 20;
     static const int MIN_OBJECTS = 4;
     
-    // Internal build method
-    std::unique_ptr<KDNode> build_recursive(
-        std::vector<std::shared_ptr<Hittable>>& objects, 
+    // Internal build method; partitions [begin, end) in place
+    KDNode* build_recursive(
+        BuildItem* begin,
+        BuildItem* end,
         const BoundingBox& bbox, 
-        int depth
+        int depth,
+        BuildScratch& scratch
     );
     
-    // Ray traversal
-    bool hit_node(
+    // Ray traversal; t_max shrinks as closer hits are found
+    bool intersect_node(
         const KDNode* node, 
         const Ray& ray, 
         float t_min, 
         float t_max, 
-        HitRecord& rec
+        Intersection& isect
     ) const;
+    bool occluded_node(const KDNode* node, const Ray& ray, float t_min, float t_max) const;
+    
+    // Quantized traversal; box is the decoded box of the node or leaf ref points to
+    template <typename Q>
+    bool intersect_quantized(const QuantizedKDNode<Q>* nodes, uint32_t ref, const BoundingBox& box,
+                             const Ray& ray, float t_min, float t_max, Intersection& isect) const;
+    template <typename Q>
+    bool occluded_quantized(const QuantizedKDNode<Q>* nodes, uint32_t ref, const BoundingBox& box,
+                            const Ray& ray, float t_min, float t_max) const;
+    
+    // Copy the finished KDNode tree into arena arrays of quantized nodes and leaves
+    template <typename Q>
+    const QuantizedKDNode<Q>* quantize_tree(const KDNode* root);
+    template <typename Q>
+    uint32_t quantize_node(const KDNode* node, const BoundingBox& box, QuantizedKDNode<Q>* nodes,
+                           int& next_node, KDLeaf* leaf_array, int& next_leaf);
+    
+    // Put a leaf's spheres in its packet and the other objects in an arena array
+    void make_leaf(KDNode* node, const BuildItem* begin, const BuildItem* end, BuildScratch& scratch);
     
     // Utility methods
-    float find_split_position(const std::vector<std::shared_ptr<Hittable>>& objects, int axis) const;
-    void partition_objects(
-        std::vector<std::shared_ptr<Hittable>>& objects,
-        int axis,
-        float split_pos,
-        std::vector<std::shared_ptr<Hittable>>& left_objects,
-        std::vector<std::shared_ptr<Hittable>>& right_objects
-    ) const;
+    float find_split_position(const BuildItem* begin, const BuildItem* end, int axis,
+                              std::vector<float>& scratch) const;
     
     // Statistics helpers
     int count_nodes(const KDNode* node) const;
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+// Memory resource that counts what passes through it
+class CountingResource : public std::pmr::memory_resource {
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream) : upstream(upstream), count(0), bytes(0) {}
+    
+    size_t allocations() const { return count; }
+    size_t bytes_allocated() const { return bytes; }
+    
+private:
+    std::pmr::memory_resource* upstream;
+    size_t count;
+    size_t bytes;
+    
+    void* do_allocate(size_t size, size_t alignment) override;
+    void do_deallocate(void* p, size_t size, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+// Monotonic arena for everything a render builds from a scene: primitives,
+// materials, their shared_ptr control blocks and accelerator nodes. Objects
+// are packed into a few large blocks in creation order, and all memory is
+// returned in one step when the arena is destroyed. Not thread-safe; scenes
+// and accelerators are built on one thread.
+class SceneArena {
+public:
+    explicit SceneArena(size_t initial_block_size = 64 * 1024);
+    SceneArena(const SceneArena&) = delete;
+    SceneArena& operator=(const SceneArena&) = delete;
+    
+    // Object and control block in one arena allocation. The arena must
+    // outlive every copy of the returned pointer.
+    template <typename T, typename... Args>
+    std::shared_ptr<T> make(Args&&... args) {
+        return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(&counted), std::forward<Args>(args)...);
+    }
+    
+    // Object that is never destroyed, only released with the arena
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+        return new (counted.allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+    
+    // Uninitialized array of trivially destructible elements
+    template <typename T>
+    T* allocate_array(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena objects are never destroyed");
+        return static_cast<T*>(counted.allocate(count * sizeof(T), alignof(T)));
+    }
+    
+    std::pmr::memory_resource* resource() { return &counted; }
+    
+    // Statistics
+    size_t allocation_count() const { return counted.allocations(); }
+    size_t bytes_used() const { return counted.bytes_allocated(); }
+    size_t block_count() const { return blocks.allocations(); }
+    size_t bytes_reserved() const { return blocks.bytes_allocated(); }
+    
+private:
+    CountingResource blocks;                     // Large blocks obtained from the heap
+    std::pmr::monotonic_buffer_resource arena;   // Carves blocks into objects
+    CountingResource counted;                    // Requests made of the arena
+};
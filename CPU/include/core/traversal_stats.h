@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+
+// Work counters for the calling thread, read before and after a pixel by the
+// cost heatmap. They are plain thread-local increments, cheap enough to stay
+// on in every render.
+struct TraversalStats {
+    uint64_t nodes_visited;    // KD-tree nodes and grid cells entered
+    uint64_t primitive_tests;  // Ray-primitive intersection and occlusion tests
+    uint64_t bounces;          // Path segments traced by the path tracer
+};
+
+inline thread_local TraversalStats traversal_stats = {0, 0, 0};
+
+// Timestamp for measuring short spans: the TSC on x86, nanoseconds elsewhere
+inline uint64_t read_cycle_counter() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
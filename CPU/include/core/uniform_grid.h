@@ -0,0 +1,52 @@
+#pragma once
+#include "core/hittable.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Uniform grid acceleration structure. Every object is referenced from each
+// cell its bounding box overlaps; rays walk the cells front to back with a
+// 3D-DDA and stop once a hit lies before the next cell boundary. Builds in
+// linear time and suits many similar-sized objects spread evenly in space.
+class UniformGrid : public Hittable {
+public:
+    UniformGrid();
+    
+    // Build the grid over objects, choosing the resolution automatically.
+    // Unless quiet, a summary goes to stderr.
+    void build(const std::vector<std::shared_ptr<Hittable>>& objects, bool quiet = false);
+    
+    // Hittable interface
+    bool intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const override;
+    bool occluded(const Ray& ray, float t_min, float t_max) const override;
+    BoundingBox bounding_box() const override;
+    
+    // Statistics
+    int get_cell_count() const;
+    size_t get_reference_count() const;
+    
+private:
+    // Cells per object, in the spirit of PBRT's and Wald's ~3 objects per cell
+    static constexpr float DENSITY = 3.0f;
+    static const int MAX_RESOLUTION = 128;
+    
+    std::vector<std::shared_ptr<Hittable>> all_objects;
+    BoundingBox bounds;
+    int resolution[3];
+    Vec3 cell_size;
+    Vec3 inv_cell_size;
+    
+    // Compressed cell lists: cell c references objects
+    // cell_objects[cell_start[c] .. cell_start[c + 1])
+    std::vector<uint32_t> cell_start;
+    std::vector<const Hittable*> cell_objects;
+    
+    void choose_resolution(size_t object_count);
+    int cell_coordinate(float position, int axis) const;
+    int cell_index(int x, int y, int z) const;
+    
+    // Walk the cells along the ray. visit(first, last, t_cell_exit) is called
+    // with each cell's object range and returns true to stop the walk.
+    template <typename Visit>
+    void traverse(const Ray& ray, float t_min, float t_max, Visit visit) const;
+};
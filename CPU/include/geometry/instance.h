@@ -0,0 +1,24 @@
+#pragma once
+#include "core/hittable.h"
+#include "math/transform.h"
+#include <memory>
+
+// Places a shared object (usually a bottom-level accelerator) in the world.
+// Rays are moved into object space at the instance boundary, so many
+// instances can reference one copy of the geometry and its acceleration tree.
+class Instance : public Hittable {
+public:
+    std::shared_ptr<Hittable> object;
+    Transform object_to_world;
+    Transform world_to_object;
+    
+    Instance(std::shared_ptr<Hittable> object, const Transform& object_to_world);
+    
+    bool intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const override;
+    void surface_interaction(const Ray& ray, const Intersection& isect, HitRecord& rec) const override;
+    bool occluded(const Ray& ray, float t_min, float t_max) const override;
+    BoundingBox bounding_box() const override;
+    
+private:
+    BoundingBox world_bbox;  // Cached, since the tree build queries it repeatedly
+};
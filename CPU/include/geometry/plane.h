@@ -0,0 +1,27 @@
+#pragma once
+#include "core/hittable.h"
+#include <memory>
+
+class Material;
+
+// Infinite plane through point with the given normal. Its bounding box is
+// unbounded, so build_world keeps it out of the accelerator.
+class Plane : public Hittable {
+public:
+    Point3 point;
+    Vec3 normal;
+    std::shared_ptr<Material> material;
+    
+    Plane(const Point3& point, const Vec3& normal, std::shared_ptr<Material> material);
+    
+    bool intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const override;
+    void surface_interaction(const Ray& ray, const Intersection& isect, HitRecord& rec) const override;
+    bool occluded(const Ray& ray, float t_min, float t_max) const override;
+    BoundingBox bounding_box() const override;
+    
+private:
+    float offset;  // dot(normal, point), so points p on the plane satisfy dot(normal, p) == offset
+    
+    // Ray parameter of the crossing, NaN or infinite if the ray is parallel
+    float crossing(const Ray& ray) const;
+};
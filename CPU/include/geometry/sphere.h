@@ -3,6 +3,7 @@
 #include <memory>
 
 class Material;
+struct Sample2D;
 
 // Sphere primitive
 class Sphere : public Hittable {
@@ -13,6 +14,15 @@ public:
     
     Sphere(const Point3& center, float radius, std::shared_ptr<Material> material);
     
-    bool hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const override;
+    bool intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const override;
+    void surface_interaction(const Ray& ray, const Intersection& isect, HitRecord& rec) const override;
+    bool occluded(const Ray& ray, float t_min, float t_max) const override;
     BoundingBox bounding_box() const override;
+    
+    // Pick a direction from ref toward the sphere, uniform over the cone it
+    // subtends. Returns false if ref is inside the sphere.
+    bool sample_solid_angle(const Point3& ref, const Sample2D& sample, Vec3& direction, float& pdf) const;
+    
+    // Density of sample_solid_angle for any direction that hits the sphere
+    float solid_angle_pdf(const Point3& ref) const;
 };
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include "core/hittable.h"
+#include <cstddef>
+#include <vector>
+
+class Sphere;
+class SceneArena;
+
+// Spheres stored as coordinate arrays so a group of them can be tested with
+// the SIMD ray-sphere kernel. The arrays live in a SceneArena and the packet
+// is trivially destructible; the owner keeps the spheres alive.
+class SpherePacket {
+public:
+    SpherePacket();
+    
+    void assign(const std::vector<const Sphere*>& spheres, SceneArena& arena);
+    
+    bool empty() const { return count == 0; }
+    size_t size() const { return count; }
+    
+    // Closest hit within [t_min, t_max], recorded as for Sphere::intersect
+    bool intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const;
+    bool occluded(const Ray& ray, float t_min, float t_max) const;
+    
+private:
+    const Sphere* const* spheres;
+    size_t count;
+    const float* center_x;
+    const float* center_y;
+    const float* center_z;
+    const float* radius;
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include "materials/material.h"
+
+// Emits constant radiance from the front face and reflects nothing
+class DiffuseLight : public Material {
+public:
+    Color emit;
+    
+    DiffuseLight(const Color& emit);
+    
+    bool scatter(const Ray& ray_in, const HitRecord& rec, Sampler& sampler, Color& attenuation, Ray& scattered) const override;
+    Color eval(const HitRecord& rec, const Vec3& direction) const override;
+    float pdf(const HitRecord& rec, const Vec3& direction) const override;
+    Color emitted(const HitRecord& rec) const override;
+    bool is_emissive() const override;
+    Color base_color() const override;
+};
@@ -8,9 +8,12 @@ public:
     
     Lambertian(const Color& albedo);
     
-    bool scatter(const Ray& ray_in, const HitRecord& rec, Color& attenuation, Ray& scattered) const override;
+    bool scatter(const Ray& ray_in, const HitRecord& rec, Sampler& sampler, Color& attenuation, Ray& scattered) const override;
+    Color eval(const HitRecord& rec, const Vec3& direction) const override;
+    float pdf(const HitRecord& rec, const Vec3& direction) const override;
+    Color base_color() const override;
     
 private:
-    Vec3 random_unit_vector() const;
+    Vec3 random_unit_vector(Sampler& sampler) const;
     bool near_zero(const Vec3& v) const;
 };
\ No newline at end of file
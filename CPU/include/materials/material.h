@@ -2,11 +2,25 @@
 #include "math/vec3.h"
 
 class Ray;
+class Sampler;
 struct HitRecord;
 
 // Simple material base class
 class Material {
 public:
     virtual ~Material() = default;
-    virtual bool scatter(const Ray& ray_in, const HitRecord& rec, Color& attenuation, Ray& scattered) const = 0;
+    // Sample an outgoing ray; implementations draw their random numbers from sampler
+    virtual bool scatter(const Ray& ray_in, const HitRecord& rec, Sampler& sampler, Color& attenuation, Ray& scattered) const = 0;
+    
+    // BSDF times cosine for an outgoing direction, and the density with which
+    // scatter() picks that direction. Used to weight explicit light samples.
+    virtual Color eval(const HitRecord& rec, const Vec3& direction) const = 0;
+    virtual float pdf(const HitRecord& rec, const Vec3& direction) const = 0;
+    
+    // Radiance emitted from the hit point toward the ray origin
+    virtual Color emitted(const HitRecord& rec) const;
+    virtual bool is_emissive() const { return false; }
+    
+    // Surface reflectance, recorded as the albedo AOV for denoising
+    virtual Color base_color() const { return Color(1, 1, 1); }
 };
\ No newline at end of file
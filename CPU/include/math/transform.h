@@ -0,0 +1,29 @@
+#pragma once
+#include "math/vec3.h"
+
+class Ray;
+
+// Affine transform stored as a 3x4 row-major matrix (rotation/scale + translation)
+class Transform {
+public:
+    float m[3][4];
+    
+    Transform();  // Identity
+    
+    static Transform translate(const Vec3& offset);
+    static Transform scale(float s);
+    static Transform rotate_y(float degrees);
+    
+    // Composition: (a * b) applies b first, then a
+    Transform operator*(const Transform& other) const;
+    Transform inverse() const;
+    
+    Point3 transform_point(const Point3& p) const;
+    Vec3 transform_vector(const Vec3& v) const;
+    
+    // Transforms a normal with the inverse-transpose; call on the inverse transform
+    Vec3 transform_normal(const Vec3& n) const;
+    
+    // Directions are not renormalized so ray parameters t stay valid across spaces
+    Ray transform_ray(const Ray& ray) const;
+};
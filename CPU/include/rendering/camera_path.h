@@ -0,0 +1,30 @@
+#pragma once
+#include "math/vec3.h"
+#include "scenes/scene.h"
+#include <string>
+#include <vector>
+
+// Camera state at a given frame
+struct CameraKeyframe {
+    float frame;
+    Point3 position;
+    Point3 target;
+    float fov;
+};
+
+// Keyframed camera path, interpolated with Catmull-Rom splines
+class CameraPath {
+public:
+    std::vector<CameraKeyframe> keyframes;  // Sorted by frame
+    
+    // Load keyframes from a text file with one keyframe per line:
+    //   frame  pos_x pos_y pos_z  target_x target_y target_z  fov
+    // Blank lines and lines starting with '#' are ignored.
+    static CameraPath load(const std::string& filename);
+    
+    int first_frame() const;
+    int last_frame() const;
+    
+    // Overwrite the camera fields of config with the path state at frame
+    void apply(float frame, SceneConfig& config) const;
+};
@@ -0,0 +1,15 @@
+#pragma once
+#include "rendering/framebuffer.h"
+#include <string>
+
+// Write a framebuffer's per-pixel cost sums, averaged per sample:
+//   <prefix>_nodes.ppm, <prefix>_primitives.ppm, <prefix>_bounces.ppm and
+//   <prefix>_cycles.ppm  - false color from blue (cheap) to red (costly),
+//                          scaled to the 99th percentile so a handful of
+//                          outliers do not flatten the rest
+//   <prefix>_cost.raw    - a text header "cost <width> <height> 4\n" then
+//                          width*height records of four native-endian
+//                          floats in the order above, rows from the top
+// A summary line per metric goes to stderr. Throws std::runtime_error when a
+// file cannot be written.
+void write_cost_maps(const std::string& prefix, const Framebuffer& framebuffer, int samples_per_pixel);
@@ -0,0 +1,27 @@
+#pragma once
+#include "rendering/framebuffer.h"
+#include "rendering/thread_pool.h"
+
+// Edge-stopping parameters for the a-trous filter
+struct DenoiseSettings {
+    int iterations = 5;           // Kernel footprint doubles each pass (5 passes = 61x61 pixels)
+    float sigma_color = 0.6f;     // Irradiance difference tolerance; its square is halved every pass
+    float sigma_albedo = 0.1f;    // Albedo difference tolerance
+    float sigma_depth = 0.02f;    // Relative depth difference tolerance per unit of step size
+};
+
+// Feature-guided a-trous wavelet denoiser (Dammertz et al. 2010).
+// The normal weight is dot(n_p, n_q)^128.
+// Requires first-hit AOVs. Lighting is demodulated by albedo so texture
+// detail survives, filtered, then remodulated.
+class Denoiser {
+public:
+    // Denoise framebuffer in place. Pixels keep the sample-sum convention,
+    // so the result is written as usual with samples_per_pixel.
+    static void denoise(
+        Framebuffer& framebuffer,
+        int samples_per_pixel,
+        ThreadPool& pool,
+        const DenoiseSettings& settings = DenoiseSettings()
+    );
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include "math/vec3.h"
+#include <iostream>
+#include <vector>
+
+class Hittable;
+
+// Auxiliary values captured at a path's first hit, used to guide denoising
+// and to record which surfaces a tile saw
+struct SurfaceAov {
+    Color albedo;
+    Vec3 normal;
+    float depth;
+    Point3 position;            // First hit point; unset on a miss
+    const Hittable* object;     // Primitive hit first, nullptr on a miss
+};
+
+// Work spent on a pixel, summed over its samples, for the cost heatmap
+struct PixelCost {
+    float nodes;        // KD-tree nodes or grid cells visited
+    float primitives;   // Primitive intersection tests
+    float bounces;      // Path segments traced
+    float cycles;       // Timestamp counter ticks
+};
+
+// Accumulated (unnormalized) sample sums, stored row-major with row 0 at the top.
+// A framebuffer may hold just a region of a larger image, such as a band of
+// rows: columns [first_column, first_column + width) and rows [first_row,
+// first_row + height) of an image_width x image_height image. Pixels are
+// addressed in image coordinates.
+struct Framebuffer {
+    int width;
+    int height;
+    int first_column;
+    int first_row;
+    int image_width;
+    int image_height;
+    std::vector<Color> pixels;
+    
+    // Optional first-hit AOV sums, same layout as pixels; empty unless enabled
+    std::vector<Color> albedo;
+    std::vector<Vec3> normal;
+    std::vector<float> depth;
+    
+    // Optional per-pixel cost sums, same layout as pixels; empty unless enabled
+    std::vector<PixelCost> cost;
+    
+    Framebuffer(int width, int height);
+    Framebuffer(int width, int height, int first_column, int first_row, int image_width, int image_height);
+    
+    void enable_aovs();
+    bool has_aovs() const { return !albedo.empty(); }
+    
+    void enable_cost_map();
+    bool has_cost_map() const { return !cost.empty(); }
+    
+    size_t index(int x, int y) const { return static_cast<size_t>(y - first_row) * width + (x - first_column); }
+    Color& at(int x, int y) { return pixels[index(x, y)]; }
+    const Color& at(int x, int y) const { return pixels[index(x, y)]; }
+};
+
+// Write the framebuffer as a plain PPM, dividing each pixel by samples_per_pixel
+void write_ppm(std::ostream& out, const Framebuffer& framebuffer, int samples_per_pixel);
+
+// Write the framebuffer's rows as binary 8-bit RGB with no header, for
+// appending bands to a binary PPM (P6) in order
+void write_rgb8_rows(std::ostream& out, const Framebuffer& framebuffer, int samples_per_pixel);
@@ -0,0 +1,73 @@
+#pragma once
+#include "rendering/renderer.h"
+#include <cstddef>
+#include <vector>
+
+// Scene edit: move a top-level sphere, given by its index in the scene's
+// object list, by offset
+struct ObjectMove {
+    size_t object;
+    Vec3 offset;
+};
+
+// Keeps a rendered frame together with the first hits of every tile, so that
+// after an edit only the tiles it can affect are rendered again and the rest
+// keep their sums. A tile is rendered again when
+//   - its camera rays hit the edited object before the edit,
+//   - its view frustum reaches the object's new bounds, or
+//   - one of its first-hit points lies within influence_distance of the
+//     object's old or new bounds, which catches nearby shadows and bounce
+//     light.
+// Changes that reach farther than influence_distance (long shadows, light
+// bounced across the scene) are left stale, except that moving an emitter
+// redoes every tile that hit anything. Tiles are rendered with the same
+// sample sequences as before, so a redone tile matches a full render exactly.
+class IncrementalRenderer {
+public:
+    IncrementalRenderer(Scene& scene, const RenderOptions& options, float influence_distance);
+    
+    IncrementalRenderer(const IncrementalRenderer&) = delete;
+    IncrementalRenderer& operator=(const IncrementalRenderer&) = delete;
+    
+    // Render every tile and record its first hits
+    void render_all();
+    
+    // Apply the edit, rebuild the accelerator (and its per-node copies, with
+    // options.numa_replicate) and render the affected tiles
+    // again. Returns the number of tiles rendered. Throws std::runtime_error
+    // if the object is not a top-level sphere.
+    int apply(const ObjectMove& move);
+    
+    // Render the current scene from scratch into a new framebuffer, leaving
+    // the kept frame alone; for measuring what apply() left stale
+    Framebuffer render_reference();
+    
+    const Framebuffer& image() const { return framebuffer; }
+    const SceneConfig& get_config() const { return config; }
+    int tile_count() const { return static_cast<int>(tiles.size()); }
+    size_t object_count() const { return world.objects.size(); }
+
+private:
+    SceneConfig config;
+    RenderOptions options;
+    float influence_distance;
+    ThreadPool pool;
+    RenderWorld world;
+    Camera camera;
+    Framebuffer framebuffer;
+    std::vector<Tile> tiles;
+    std::vector<TileFirstHits> first_hits;  // One per tile, from its last render
+    
+    // Clear the tiles' sums and render them again
+    void render_tiles(const std::vector<int>& indices);
+    
+    // Whether any camera ray of the tile, anywhere within its pixels, can reach box
+    bool frustum_reaches(const Tile& tile, const BoundingBox& box) const;
+};
+
+// Render the scene, then apply each move in turn, rendering only the affected
+// tiles again, and write the final image to stdout. Reports the time of each
+// update against the full render. With check, every edited frame is also
+// rendered in full and the difference reported.
+void render_edits(std::unique_ptr<Scene> scene, const RenderOptions& options,
+                  const std::vector<ObjectMove>& moves, float influence_distance, bool check);
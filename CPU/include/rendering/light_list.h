@@ -0,0 +1,32 @@
+#pragma once
+#include "core/hittable.h"
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+class Sphere;
+struct Sample2D;
+
+// Emissive spheres that can be sampled explicitly (next-event estimation).
+// Only top-level spheres are collected; emitters inside instances or
+// accelerators are still found by BSDF sampling.
+class LightList {
+public:
+    void build(const std::vector<std::shared_ptr<Hittable>>& objects);
+    
+    bool empty() const { return lights.empty(); }
+    size_t size() const { return lights.size(); }
+    bool contains(const Hittable* object) const { return light_set.count(object) != 0; }
+    
+    // Choose a light uniformly and a direction toward it. The pdf includes
+    // the light selection probability.
+    bool sample(const Point3& ref, float select, const Sample2D& sample,
+                const Sphere*& light, Vec3& direction, float& pdf) const;
+    
+    // Density with which sample() produces a direction that hits object
+    float pdf(const Point3& ref, const Hittable* object) const;
+    
+private:
+    std::vector<const Sphere*> lights;
+    std::unordered_set<const Hittable*> light_set;
+};
@@ -0,0 +1,8 @@
+#pragma once
+#include "rendering/renderer.h"
+
+// Render the scene with the threads of one NUMA node, then with every node
+// unpinned, pinned, and pinned with a per-node accelerator copy, and report
+// each setup's best time of three and its speedup over the single node.
+// On a machine with one node only the placement overhead can be seen.
+void numa_scaling_benchmark(Scene& scene, const RenderOptions& options);
@@ -0,0 +1,46 @@
+#pragma once
+#include "core/hittable.h"
+#include "core/scene_arena.h"
+#include "rendering/light_list.h"
+#include "utils/numa.h"
+#include <memory>
+#include <vector>
+
+enum class AcceleratorType {
+    List,               // Linear list, every object tested
+    KDTree,             // Median-split kd-tree
+    KDTreeQuantized16,  // Same tree, child boxes stored in 16 bits per bound
+    KDTreeQuantized8,   // Same tree, child boxes stored in 8 bits per bound
+    Grid                // Uniform grid with 3D-DDA traversal
+};
+
+inline const char* accelerator_name(AcceleratorType type) {
+    switch (type) {
+        case AcceleratorType::List: return "Linear List";
+        case AcceleratorType::KDTree: return "KD-Tree";
+        case AcceleratorType::KDTreeQuantized16: return "KD-Tree (16-bit nodes)";
+        case AcceleratorType::KDTreeQuantized8: return "KD-Tree (8-bit nodes)";
+        case AcceleratorType::Grid: return "Uniform Grid";
+    }
+    return "unknown";
+}
+
+// Everything a frame needs from the scene, built once and shared by all frames.
+// The arenas are declared first so they are released after everything that points into them.
+struct RenderWorld {
+    std::shared_ptr<SceneArena> arena;               // Backs objects, materials and kd-tree nodes
+    std::vector<std::shared_ptr<SceneArena>> replica_arenas;  // Back replicas, each on its node
+    std::vector<std::shared_ptr<Hittable>> objects;  // Owns primitives and materials
+    std::shared_ptr<Hittable> accelerator;           // Queries over objects; unbounded ones sit beside the tree
+    LightList lights;                                // Emitters for next-event estimation
+    
+    // Optional copies of accelerator per NUMA node, indexed as NumaTopology;
+    // a null or missing entry means that node uses accelerator
+    std::vector<std::shared_ptr<Hittable>> replicas;
+    
+    // The accelerator copy in the calling thread's node's memory
+    const Hittable& local_accelerator() const {
+        size_t node = static_cast<size_t>(thread_numa_node);
+        return node < replicas.size() && replicas[node] ? *replicas[node] : *accelerator;
+    }
+};
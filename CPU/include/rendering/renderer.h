@@ -2,18 +2,160 @@
 #include "math/vec3.h"
 #include "scenes/scene.h"
 #include "core/hittable.h"
+#include "rendering/camera.h"
+#include "rendering/camera_path.h"
+#include "rendering/framebuffer.h"
+#include "rendering/render_world.h"
+#include "rendering/thread_pool.h"
+#include "sampling/sampler.h"
 #include <memory>
 #include <chrono>
+#include <string>
+#include <vector>
+
+// Command-line overrides applied on top of a scene's SceneConfig
+struct RenderOptions {
+    AcceleratorType accelerator = AcceleratorType::KDTree;
+    int samples_per_pixel = 0;  // 0 keeps the scene's own setting
+    bool denoise = false;       // Capture first-hit AOVs and run the denoiser
+    SamplerType sampler = SamplerType::Independent;
+    uint32_t seed = 0;          // Base seed for the sampler; equal seeds give equal images
+    int time_budget_ms = 0;     // > 0 selects progressive rendering with this deadline
+    std::string preview_prefix; // Progressive mode: write <prefix>_passN.ppm after each pass
+    bool ambient_occlusion = false; // Render ambient occlusion instead of path tracing
+    float ao_distance = 1.0f;   // Occluders farther than this along an AO ray are ignored
+    bool ao_closest_hit = false; // Answer AO rays with hit() instead of occluded(), for comparison
+    int image_width = 0;        // 0 keeps the scene's own width
+    bool stream = false;        // Render in bands and write each to stdout as it finishes
+    int stream_window = 0;      // Bands held in memory when streaming; 0 = twice the thread count
+    std::string heatmap_prefix; // Non-empty: also write per-pixel cost maps as <prefix>_*.ppm/.raw
+    bool numa = false;          // Pin threads to cores and keep framebuffer rows on the node rendering them
+    bool numa_replicate = false; // Also give every other NUMA node its own copy of the accelerator
+    
+    void apply(SceneConfig& config) const;
+    ThreadPlacement thread_placement() const;
+};
+
+// Rectangle of pixels [x0, x1) x [y0, y1), rows counted from the top of the image
+struct Tile {
+    int x0, y0, x1, y1;
+};
+
+// First hits of one tile's camera rays, recorded by render_tile so that a
+// later scene edit can tell whether the tile saw what was edited
+struct TileFirstHits {
+    std::vector<const Hittable*> objects;   // Distinct primitives hit, sorted
+    std::vector<BoundingBox> pixel_bounds;  // Per tile pixel, row-major: box around its first-hit
+                                            // points, inside out (min > max) if every sample missed
+};
 
 class Renderer {
 public:
     // Render a scene and output to stdout
-    static void render_scene(std::unique_ptr<Scene> scene, bool use_kdtree = true);
+    static void render_scene(std::unique_ptr<Scene> scene, const RenderOptions& options = RenderOptions());
+    
+    // Render frames [first_frame, last_frame] along a camera path to
+    // <output_prefix>_NNNN.ppm. Scene, accelerator and worker threads are
+    // built once, and writing frame N overlaps with rendering frame N+1.
+    static void render_animation(
+        std::unique_ptr<Scene> scene,
+        const RenderOptions& options,
+        const CameraPath& path,
+        int first_frame,
+        int last_frame,
+        const std::string& output_prefix
+    );
+    
+    // Render in passes of doubling sample count (1, 2, 4, ... up to the scene's
+    // samples_per_pixel) until options.time_budget_ms runs out, then write the
+    // best available image to stdout. The deadline is checked before each tile;
+    // the first pass always completes so there is an image to show.
+    static void render_progressive(std::unique_ptr<Scene> scene, const RenderOptions& options);
+    
+    // Render the image in bands one tile high and write it to stdout as a
+    // binary PPM (P6), band by band in order. At most options.stream_window
+    // bands of sample sums exist at once, so memory does not grow with the
+    // image height; threads keep taking tiles from later bands in the window
+    // while the oldest one is written. Denoising and AOVs are not available.
+    static void render_streaming(std::unique_ptr<Scene> scene, const RenderOptions& options);
+    
+    // Create the scene's objects in a fresh arena and build the acceleration
+    // structure (or plain list) and light list over them, reporting build
+    // time and allocation counts to stderr unless quiet
+    static RenderWorld build_world(Scene& scene, AcceleratorType accelerator, bool quiet = false);
+    
+    // Give each NUMA node of pool other than the first its own copy of the
+    // accelerator, built in that node's memory; see RenderWorld::replicas.
+    // Primitives and materials stay shared.
+    static void replicate_accelerator(RenderWorld& world, AcceleratorType accelerator, const ThreadPool& pool);
+    
+    // The acceleration structure (or plain list) part of build_world. Tree
+    // nodes go to arena, or to memory of the tree's own when it is null.
+    static std::shared_ptr<Hittable> build_accelerator(
+        const std::vector<std::shared_ptr<Hittable>>& objects,
+        AcceleratorType accelerator,
+        SceneArena* arena,
+        bool quiet = false
+    );
+    
+    // Render one frame of sample sums into framebuffer, in parallel over tiles.
+    // First-hit AOVs are accumulated too when the framebuffer has them enabled.
+    static void render_frame(
+        const RenderWorld& world,
+        const Camera& cam,
+        const SceneConfig& config,
+        const RenderOptions& options,
+        ThreadPool& pool,
+        Framebuffer& framebuffer,
+        bool show_progress = false
+    );
     
-    // Ray color calculation
-    static Color ray_color(const Ray& ray, const Hittable& world, int depth);
+    // Split an image into TILE_SIZE x TILE_SIZE tiles in row-major order
+    static std::vector<Tile> make_tiles(int width, int height);
     
+    // Add samples [first_sample, first_sample + sample_count) of every pixel in
+    // tile to the framebuffer's sums (and AOV sums, if enabled). When
+    // first_hits is given it is overwritten with this call's first hits.
+    static void render_tile(
+        const RenderWorld& world,
+        const Camera& cam,
+        const SceneConfig& config,
+        const RenderOptions& options,
+        Framebuffer& framebuffer,
+        const Tile& tile,
+        int first_sample,
+        int sample_count,
+        TileFirstHits* first_hits = nullptr
+    );
+    
+    // Path-traced radiance along a camera ray, with next-event estimation and
+    // multiple importance sampling when the world has lights. Fills aov (if
+    // given) from the first hit.
+    static Color ray_color(
+        const Ray& ray,
+        const RenderWorld& world,
+        const SceneConfig& config,
+        Sampler& sampler,
+        SurfaceAov* aov = nullptr
+    );
+    
+    // Ambient occlusion at the first hit: one cosine-distributed visibility ray
+    // per sample, white where unoccluded within options.ao_distance
+    static Color ambient_occlusion(
+        const Ray& ray,
+        const RenderWorld& world,
+        const RenderOptions& options,
+        Sampler& sampler,
+        SurfaceAov* aov = nullptr
+    );
+
 private:
+    static const int TILE_SIZE = 16;
+    static constexpr float MISS_DEPTH = 1e4f;  // Depth AOV for rays that escape
+    static constexpr float SHADOW_EPSILON_SCALE = 0.9999f;  // Stops shadow rays just short of the light
+    
+    static Color background(const Ray& ray, const SceneConfig& config);
+    
     // Performance timing
     static void print_render_stats(
         const std::chrono::high_resolution_clock::time_point& start_time,
@@ -21,4 +163,4 @@ private:
         int total_pixels,
         int samples_per_pixel
     );
-};
\ No newline at end of file
+};
@@ -0,0 +1,8 @@
+#pragma once
+#include "rendering/renderer.h"
+
+// Render the scene with every sampler and report the RMSE against a
+// high-spp reference, both at equal sample counts and at equal render time
+// (the time the independent sampler needs for the base sample count).
+// The base sample count is options.samples_per_pixel, or 16 if unset.
+void compare_samplers(Scene& scene, const RenderOptions& options, int reference_spp);
@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Where a pool's threads run
+struct ThreadPlacement {
+    bool pin = false;   // One core per thread, filling NUMA nodes one after another
+    int max_nodes = 0;  // With pin: use only the first max_nodes nodes; 0 = all
+};
+
+// Fixed set of worker threads kept alive across frames.
+// The calling thread also takes part in parallel_for, so a pool of size N
+// owns N-1 worker threads.
+class ThreadPool {
+public:
+    // 0 threads = one per hardware thread, or with pinning one per core of
+    // the nodes used. A pinned pool also pins the calling thread to the
+    // first core until it is destroyed.
+    explicit ThreadPool(int num_threads = 0, ThreadPlacement placement = ThreadPlacement());
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    int size() const;
+    
+    // NUMA nodes the threads are pinned to, numbered as in NumaTopology;
+    // 1 for an unpinned pool
+    int node_count() const;
+    
+    // Runs task(i) for every i in [0, count) and blocks until all have finished.
+    // Indices are handed out dynamically, so uneven tasks balance themselves.
+    // On more than one node, [0, count) is split into one contiguous range
+    // per node (see node_range) and threads start on their own node's range,
+    // moving to other ranges only once it is used up.
+    // If a task throws, the indices not yet started are skipped and the first
+    // exception is rethrown here once every thread has stopped.
+    // Not reentrant: only one parallel_for may run at a time.
+    void parallel_for(int count, const std::function<void(int)>& task);
+    
+    // The range of parallel_for(count, ...) indices node's threads take first,
+    // in proportion to its share of the threads
+    void node_range(int count, int node, int& begin, int& end) const;
+
+private:
+    std::vector<std::thread> workers;
+    
+    // Pinning; empty for an unpinned pool. Entry i is for thread i, the caller being 0.
+    std::vector<int> thread_cpus;
+    std::vector<int> thread_nodes;
+    std::vector<int> threads_per_node;
+    std::vector<int> caller_cpus;             // Caller's affinity before pinning, restored at the end
+    std::unique_ptr<std::atomic<int>[]> node_next;  // Per node: next index of its range
+    std::vector<int> node_end;                      // Per node: end of its range
+    
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    
+    const std::function<void(int)>* current_task;
+    int task_count;
+    std::atomic<int> next_index;
+    int busy_workers;
+    unsigned long generation;
+    bool stopping;
+    std::atomic<bool> task_failed;
+    std::exception_ptr task_error;  // First exception of this parallel_for, guarded by mutex
+    
+    void worker_loop(int index);
+    void run_tasks();
+    void run_task(int index);
+};
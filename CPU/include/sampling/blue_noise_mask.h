@@ -0,0 +1,21 @@
+#pragma once
+#include <vector>
+
+// Tileable 64x64 blue-noise threshold mask, generated once on first use
+// with the void-and-cluster method (Ulichney 1993)
+class BlueNoiseMask {
+public:
+    static const int SIZE = 64;
+    
+    static const BlueNoiseMask& instance();
+    
+    // Value in [0, 1), wrapping toroidally
+    float value(int x, int y) const {
+        return values[(y & (SIZE - 1)) * SIZE + (x & (SIZE - 1))];
+    }
+    
+private:
+    std::vector<float> values;
+    
+    BlueNoiseMask();
+};
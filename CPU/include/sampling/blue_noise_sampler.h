@@ -0,0 +1,23 @@
+#pragma once
+#include "sampling/sampler.h"
+
+// Scrambled Sobol points shared by all pixels, toroidally shifted per pixel
+// by a blue-noise mask. Neighboring pixels get well-spread offsets, so the
+// remaining error at low sample counts is high-frequency and looks like fine grain.
+class BlueNoiseSampler : public Sampler {
+public:
+    explicit BlueNoiseSampler(uint32_t seed);
+    
+    void start_pixel_sample(int x, int y, int index) override;
+    float get_1d() override;
+    Sample2D get_2d() override;
+    
+private:
+    uint32_t seed;
+    int pixel_x, pixel_y;
+    uint32_t index;
+    uint32_t dimension;
+    
+    // Blue-noise offset for a dimension; each dimension reads the mask at a different shift
+    float mask_offset(uint32_t dim) const;
+};
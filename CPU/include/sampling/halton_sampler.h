@@ -0,0 +1,22 @@
+#pragma once
+#include "sampling/sampler.h"
+
+// Halton sequence with one prime base per dimension. Every pixel walks the
+// same points, decorrelated by a per-pixel random toroidal shift
+// (Cranley-Patterson rotation). Dimensions past the prime table get random values.
+class HaltonSampler : public Sampler {
+public:
+    explicit HaltonSampler(uint32_t seed);
+    
+    void start_pixel_sample(int x, int y, int index) override;
+    float get_1d() override;
+    Sample2D get_2d() override;
+    
+private:
+    uint32_t seed;
+    uint32_t pixel_seed;
+    uint32_t index;
+    uint32_t dimension;
+    
+    float sample_dimension(uint32_t dim) const;
+};
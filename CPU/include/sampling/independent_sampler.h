@@ -0,0 +1,20 @@
+#pragma once
+#include "sampling/sampler.h"
+
+// Uniform random numbers with no correlation between samples. Values are
+// hashed from (pixel, sample, dimension), so they do not depend on which
+// thread renders the pixel.
+class IndependentSampler : public Sampler {
+public:
+    explicit IndependentSampler(uint32_t seed);
+    
+    void start_pixel_sample(int x, int y, int index) override;
+    float get_1d() override;
+    Sample2D get_2d() override;
+    
+private:
+    uint32_t seed;
+    uint32_t pixel_seed;
+    uint32_t index;
+    uint32_t dimension;
+};
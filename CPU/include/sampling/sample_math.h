@@ -0,0 +1,124 @@
+#pragma once
+#include <cstdint>
+
+// Integer hashing and bit tricks shared by the samplers
+
+// Avalanching 32-bit mix (lowbias32 by Chris Wellons)
+inline uint32_t hash_u32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352dU;
+    x ^= x >> 15;
+    x *= 0x846ca68bU;
+    x ^= x >> 16;
+    return x;
+}
+
+inline uint32_t hash_combine(uint32_t seed, uint32_t value) {
+    return hash_u32(seed ^ (value + 0x9e3779b9U + (seed << 6) + (seed >> 2)));
+}
+
+inline uint32_t reverse_bits(uint32_t x) {
+    x = (x << 16) | (x >> 16);
+    x = ((x & 0x00ff00ffU) << 8) | ((x & 0xff00ff00U) >> 8);
+    x = ((x & 0x0f0f0f0fU) << 4) | ((x & 0xf0f0f0f0U) >> 4);
+    x = ((x & 0x33333333U) << 2) | ((x & 0xccccccccU) >> 2);
+    x = ((x & 0x55555555U) << 1) | ((x & 0xaaaaaaaaU) >> 1);
+    return x;
+}
+
+// Owen scrambling of a bit-reversed value (Burley 2020, "Practical Hash-based Owen Scrambling")
+inline uint32_t laine_karras_permutation(uint32_t x, uint32_t seed) {
+    x += seed;
+    x ^= x * 0x6c50b47cU;
+    x ^= x * 0xb82f1e52U;
+    x ^= x * 0xc7afe638U;
+    x ^= x * 0x8d22f6e6U;
+    return x;
+}
+
+inline uint32_t nested_uniform_scramble(uint32_t x, uint32_t seed) {
+    return reverse_bits(laine_karras_permutation(reverse_bits(x), seed));
+}
+
+// First two Sobol dimensions, as 32-bit fixed point
+inline uint32_t sobol_dim0(uint32_t index) {
+    return reverse_bits(index);
+}
+
+// Sobol dimension 1 is linear over GF(2) in the index bits, so it can be
+// evaluated one index byte at a time from precomputed XOR tables
+struct SobolDim1Table {
+    uint32_t bytes[4][256];
+};
+
+constexpr SobolDim1Table make_sobol_dim1_table() {
+    SobolDim1Table table = {};
+    uint32_t columns[32] = {};
+    uint32_t v = 1U << 31;
+    for (int bit = 0; bit < 32; bit++, v ^= v >> 1) {
+        columns[bit] = v;
+    }
+    for (int byte = 0; byte < 4; byte++) {
+        for (uint32_t value = 0; value < 256; value++) {
+            uint32_t result = 0;
+            for (int bit = 0; bit < 8; bit++) {
+                if (value & (1U << bit)) result ^= columns[byte * 8 + bit];
+            }
+            table.bytes[byte][value] = result;
+        }
+    }
+    return table;
+}
+
+inline constexpr SobolDim1Table SOBOL_DIM1_TABLE = make_sobol_dim1_table();
+
+inline uint32_t sobol_dim1(uint32_t index) {
+    return SOBOL_DIM1_TABLE.bytes[0][index & 0xff]
+         ^ SOBOL_DIM1_TABLE.bytes[1][(index >> 8) & 0xff]
+         ^ SOBOL_DIM1_TABLE.bytes[2][(index >> 16) & 0xff]
+         ^ SOBOL_DIM1_TABLE.bytes[3][index >> 24];
+}
+
+// Map 32-bit fixed point to [0, 1), never returning 1.0f
+inline float to_unit_float(uint32_t x) {
+    return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+// Random permutation of [0, length) selected by seed, evaluated without tables
+// (Kensler 2013, "Correlated Multi-Jittered Sampling")
+inline uint32_t permute_index(uint32_t i, uint32_t length, uint32_t seed) {
+    uint32_t w = length - 1;
+    w |= w >> 1;
+    w |= w >> 2;
+    w |= w >> 4;
+    w |= w >> 8;
+    w |= w >> 16;
+    do {
+        i ^= seed;
+        i *= 0xe170893dU;
+        i ^= seed >> 16;
+        i ^= (i & w) >> 4;
+        i ^= seed >> 8;
+        i *= 0x0929eb3fU;
+        i ^= seed >> 23;
+        i ^= (i & w) >> 1;
+        i *= 1 | seed >> 27;
+        i *= 0x6935fa69U;
+        i ^= (i & w) >> 11;
+        i *= 0x74dcb303U;
+        i ^= (i & w) >> 2;
+        i *= 0x9e501cc3U;
+        i ^= (i & w) >> 2;
+        i *= 0xc860a3dfU;
+        i &= w;
+        i ^= i >> 5;
+    } while (i >= length);
+    return (i + seed) % length;
+}
+
+// Largest float below 1, for clamping results of float arithmetic into [0, 1)
+const float ONE_MINUS_EPSILON = 0x1.fffffep-1f;
+
+inline float clamp_unit(float v) {
+    return v < ONE_MINUS_EPSILON ? v : ONE_MINUS_EPSILON;
+}
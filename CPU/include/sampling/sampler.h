@@ -0,0 +1,41 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+
+struct Sample2D {
+    float u, v;
+};
+
+// Source of sample values for one render thread.
+// Each pixel sample consumes dimensions in a fixed order: the pixel jitter
+// first, then the same dimensions at every bounce, so a given dimension
+// index always means the same thing and structured sequences stay stratified.
+class Sampler {
+public:
+    virtual ~Sampler() = default;
+    
+    // Begin sample `index` of a pixel; resets the dimension counter
+    virtual void start_pixel_sample(int x, int y, int index) = 0;
+    
+    // Values in [0, 1), each call consumes the next dimension(s)
+    virtual float get_1d() = 0;
+    virtual Sample2D get_2d() = 0;
+};
+
+enum class SamplerType {
+    Independent,
+    Stratified,
+    Halton,
+    Sobol,
+    BlueNoise
+};
+
+// Create a sampler for one thread. Samplers built with the same seed produce
+// the same sequence, so renders are reproducible.
+std::unique_ptr<Sampler> make_sampler(SamplerType type, int samples_per_pixel, uint32_t seed);
+
+const char* sampler_name(SamplerType type);
+
+// Parse "independent", "stratified", "halton", "sobol" or "bluenoise"; returns false if unknown
+bool parse_sampler_type(const std::string& name, SamplerType& type);
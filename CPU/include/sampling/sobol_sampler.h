@@ -0,0 +1,21 @@
+#pragma once
+#include "sampling/sampler.h"
+
+// Owen-scrambled Sobol points. Each dimension pair is an independently
+// shuffled and scrambled copy of the first two Sobol dimensions, which keeps
+// every 2D projection a (0,2)-sequence without direction-number tables
+// (Burley 2020, "Practical Hash-based Owen Scrambling").
+class SobolSampler : public Sampler {
+public:
+    explicit SobolSampler(uint32_t seed);
+    
+    void start_pixel_sample(int x, int y, int index) override;
+    float get_1d() override;
+    Sample2D get_2d() override;
+    
+private:
+    uint32_t seed;
+    uint32_t pixel_seed;
+    uint32_t index;
+    uint32_t dimension;
+};
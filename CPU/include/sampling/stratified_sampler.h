@@ -0,0 +1,22 @@
+#pragma once
+#include "sampling/sampler.h"
+
+// Jittered stratification of each dimension (pair) over the pixel's samples.
+// Strata are visited in a per-pixel, per-dimension random order so that
+// dimensions stay uncorrelated with each other.
+class StratifiedSampler : public Sampler {
+public:
+    StratifiedSampler(int samples_per_pixel, uint32_t seed);
+    
+    void start_pixel_sample(int x, int y, int index) override;
+    float get_1d() override;
+    Sample2D get_2d() override;
+    
+private:
+    uint32_t samples_per_pixel;
+    uint32_t strata_x, strata_y;  // 2D grid, strata_x * strata_y <= samples_per_pixel
+    uint32_t seed;
+    uint32_t pixel_seed;
+    uint32_t index;
+    uint32_t dimension;
+};
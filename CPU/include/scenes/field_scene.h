@@ -0,0 +1,14 @@
+#pragma once
+#include "scenes/scene.h"
+
+// Over a million small spheres scattered across a plane, for measuring
+// accelerators at a scale where node memory matters
+class FieldScene : public Scene {
+public:
+    std::vector<std::shared_ptr<Hittable>> create_objects(SceneArena& arena) override;
+    SceneConfig get_config() override;
+    const char* get_name() override;
+    
+private:
+    static const int GRID_SIZE = 1024;  // Spheres per side, one per unit cell
+};
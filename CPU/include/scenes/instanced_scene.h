@@ -0,0 +1,13 @@
+#pragma once
+#include "scenes/scene.h"
+
+// Grid of instances that all share one small cluster of spheres
+class InstancedScene : public Scene {
+public:
+    std::vector<std::shared_ptr<Hittable>> create_objects(SceneArena& arena) override;
+    SceneConfig get_config() override;
+    const char* get_name() override;
+    
+private:
+    std::shared_ptr<Hittable> create_cluster(SceneArena& arena) const;
+};
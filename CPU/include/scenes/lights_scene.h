@@ -0,0 +1,10 @@
+#pragma once
+#include "scenes/scene.h"
+
+// Closed room lit only by small emissive spheres
+class LightsScene : public Scene {
+public:
+    std::vector<std::shared_ptr<Hittable>> create_objects(SceneArena& arena) override;
+    SceneConfig get_config() override;
+    const char* get_name() override;
+};
@@ -4,6 +4,8 @@
 #include <vector>
 #include <memory>
 
+class SceneArena;
+
 // Scene configuration struct
 struct SceneConfig {
     float aspect_ratio = 16.0f / 9.0f;
@@ -16,6 +18,9 @@ struct SceneConfig {
     Vec3 camera_up = Vec3(0, 1, 0);
     float camera_fov = 90.0f;
     
+    bool sky = true;                      // Blue-white gradient for escaping rays
+    Color background = Color(0, 0, 0);    // Used instead when sky is false
+    
     int get_image_height() const {
         return static_cast<int>(image_width / aspect_ratio);
     }
@@ -25,7 +30,8 @@ struct SceneConfig {
 class Scene {
 public:
     virtual ~Scene() = default;
-    virtual std::vector<std::shared_ptr<Hittable>> create_objects() = 0;
+    // Objects and materials are allocated in arena, which must outlive them
+    virtual std::vector<std::shared_ptr<Hittable>> create_objects(SceneArena& arena) = 0;
     virtual SceneConfig get_config() = 0;
     virtual const char* get_name() = 0;
 };
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+#include "scenes/scene.h"
+#include <memory>
+#include <string>
+
+// Create a built-in scene by its command-line name ("simple", "complex", ...).
+// Returns nullptr for unknown names.
+std::unique_ptr<Scene> create_scene(const std::string& name);
+
+// Space-separated list of the known scene names, for usage messages
+const char* scene_names();
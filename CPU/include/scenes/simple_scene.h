@@ -3,7 +3,7 @@
 
 class SimpleScene : public Scene {
 public:
-    std::vector<std::shared_ptr<Hittable>> create_objects() override;
+    std::vector<std::shared_ptr<Hittable>> create_objects(SceneArena& arena) override;
     SceneConfig get_config() override;
     const char* get_name() override;
 };
\ No newline at end of file
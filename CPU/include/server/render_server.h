@@ -0,0 +1,104 @@
+#pragma once
+#include "rendering/renderer.h"
+#include "server/scene_cache.h"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Long-lived render service. Built scenes stay cached between jobs and all
+// jobs share one thread pool, so a request only pays for its own pixels.
+//
+// Requests are text lines, one per job:
+//   render id=<name> scene=<scene> [width=<px>] [spp=<n>] [priority=<n>]
+//          [camera=px,py,pz,tx,ty,tz,fov] [format=rgb8|float]
+//   stats
+//   shutdown            (socket mode; stdin mode stops at end of input)
+// Each finished job is answered with a header line followed by raw pixels:
+//   result <id> <width> <height> <rgb8|float> <bytes> <queue_ms> <render_ms>\n<bytes>
+// rgb8 is gamma-corrected 8-bit RGB; float is averaged linear RGB float32,
+// both row-major from the top. Failures are answered with "error <id> <message>\n";
+// width must be at least 2, fov in (0, 180), and the image at most 64M pixels.
+// Higher priorities run first; equal priorities run in arrival order.
+class RenderServer {
+public:
+    RenderServer(const RenderOptions& options, size_t cache_capacity);
+    ~RenderServer();
+    
+    // Read requests from stdin and write responses to stdout until end of input
+    void serve_stdio();
+    
+    // Accept connections on a Unix domain socket until a shutdown request
+    void serve_socket(const std::string& path);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    struct Connection;
+    
+    struct Job {
+        std::string id;
+        std::string scene;
+        int width = 0;            // 0 keeps the scene's resolution
+        int samples_per_pixel = 0;
+        int priority = 0;
+        bool has_camera = false;
+        Point3 camera_pos;
+        Point3 camera_target;
+        float camera_fov = 0.0f;
+        bool float_output = false;
+        
+        std::shared_ptr<Connection> connection;
+        Clock::time_point submitted;
+        unsigned long sequence = 0;
+    };
+    
+    struct JobOrder {
+        bool operator()(const Job& a, const Job& b) const {
+            if (a.priority != b.priority) return a.priority < b.priority;
+            return a.sequence > b.sequence;
+        }
+    };
+    
+    RenderOptions options;
+    ThreadPool pool;
+    
+    // Socket mode: one reader thread per client, joined when the server stops
+    struct ConnectionThread {
+        std::shared_ptr<Connection> connection;
+        std::thread thread;
+    };
+    std::mutex connections_mutex;
+    std::vector<ConnectionThread> connection_threads;
+    SceneCache cache;
+    mutable std::mutex cache_mutex;  // Dispatcher builds scenes while connections read stats
+    
+    mutable std::mutex queue_mutex;
+    std::condition_variable queue_changed;
+    std::priority_queue<Job, std::vector<Job>, JobOrder> queue;
+    unsigned long next_sequence;
+    bool accepting;
+    
+    // Metrics, guarded by queue_mutex
+    size_t jobs_completed;
+    size_t jobs_failed;
+    size_t max_queue_depth;
+    double total_latency_ms;
+    double max_latency_ms;
+    
+    void handle_connection(std::shared_ptr<Connection> connection);
+    void join_finished_connections();
+    void handle_request(const std::string& line, const std::shared_ptr<Connection>& connection);
+    bool parse_job(const std::string& line, Job& job, std::string& error) const;
+    void submit(Job job);
+    
+    // Dispatcher: runs queued jobs one at a time on the shared pool
+    void dispatch_jobs();
+    void run_job(const Job& job);      // Answers failures with an error line
+    void execute_job(const Job& job);  // Throws on failure
+    
+    std::string stats() const;
+};
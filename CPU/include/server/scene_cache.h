@@ -0,0 +1,42 @@
+#pragma once
+#include "rendering/render_world.h"
+#include "rendering/thread_pool.h"
+#include "scenes/scene.h"
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+// A scene with its accelerator already built, ready to render from any camera
+struct CachedScene {
+    std::string name;
+    SceneConfig config;
+    RenderWorld world;
+};
+
+// Least-recently-used cache of built scenes. Not thread-safe; callers
+// serialize access.
+class SceneCache {
+public:
+    explicit SceneCache(size_t capacity);
+    
+    // Return the cached scene, building it (and evicting the least recently
+    // used entry if full) on a miss. Returns nullptr for unknown scene names.
+    // With replicate_for, a newly built accelerator is also copied to every
+    // NUMA node of that pool.
+    std::shared_ptr<const CachedScene> get(const std::string& name, AcceleratorType accelerator,
+                                           const ThreadPool* replicate_for = nullptr);
+    
+    size_t size() const { return entries.size(); }
+    size_t hits() const { return hit_count; }
+    size_t misses() const { return miss_count; }
+
+private:
+    using Entry = std::pair<std::string, std::shared_ptr<const CachedScene>>;
+    
+    size_t capacity;
+    std::list<Entry> entries;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index;
+    size_t hit_count;
+    size_t miss_count;
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+
+// Instruction-set levels the SIMD kernels are compiled for, lowest first.
+// Baseline is whatever the compiler targets by default (SSE2 on x86-64).
+enum class Isa {
+    Baseline,
+    SSE42,
+    AVX2,
+    AVX512
+};
+
+// Highest level this CPU and this build both support, from CPUID
+Isa detect_isa();
+
+bool isa_supported(Isa isa);
+const char* isa_name(Isa isa);
+bool parse_isa(const std::string& name, Isa& isa);
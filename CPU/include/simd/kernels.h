@@ -0,0 +1,56 @@
+#pragma once
+#include "simd/cpu_features.h"
+#include <cstddef>
+#include <cstdint>
+
+class Ray;
+
+// Ray in plain floats, set up once per query for the kernels
+struct KernelRay {
+    float origin[3];
+    float direction[3];
+    float inv_direction[3];
+    
+    explicit KernelRay(const Ray& ray);
+};
+
+// Boxes as separate coordinate arrays: min_x, min_y, min_z, max_x, max_y, max_z
+struct BoxArrays {
+    const float* bounds[6];
+};
+
+// Spheres as separate arrays so the kernels can test several per instruction
+struct SphereArrays {
+    const float* center_x;
+    const float* center_y;
+    const float* center_z;
+    const float* radius;
+};
+
+// Hot loops compiled once per ISA level. Each translation unit that fills a
+// table is built with its own -m flags, so everything it calls must be local
+// to it; see src/simd/kernels_impl.h.
+struct SimdKernels {
+    Isa isa;
+    
+    // hits[i] = 1 if the ray overlaps box i within (t_min, t_max), else 0
+    void (*ray_boxes)(const BoxArrays& boxes, size_t count, const KernelRay& ray,
+                      float t_min, float t_max, uint8_t* hits);
+    
+    // Index of the closest sphere hit within [t_min, t_max], or -1; sets t
+    int (*ray_spheres)(const SphereArrays& spheres, size_t count, const KernelRay& ray,
+                       float t_min, float t_max, float& t);
+    
+    // dst[i] += src[i]
+    void (*accumulate)(float* dst, const float* src, size_t count);
+    
+    // Scale sample sums, gamma-correct (gamma 2) and quantize to [0, 255]
+    void (*tonemap_rgb8)(const float* src, size_t count, float scale, uint8_t* dst);
+};
+
+// The kernel table for the selected ISA, chosen on first use
+const SimdKernels& simd_kernels();
+
+// Force a level instead of the CPUID choice; must be called before the
+// first simd_kernels(). Throws std::runtime_error if the CPU lacks it.
+void select_isa(Isa isa);
@@ -0,0 +1,12 @@
+#pragma once
+#include <cstddef>
+
+// Number of global operator new calls so far in this process. Used by the
+// build statistics to show how many heap allocations a phase made. Only
+// programs that link the counting operator new (src/counting_new.cpp, part
+// of the raytracer executable) are counted; in other hosts of the library
+// this stays 0.
+size_t heap_allocation_count();
+
+// Called by the counting operator new for every allocation
+void note_heap_allocation();
@@ -2,4 +2,7 @@
 #include "math/vec3.h"
 #include <iostream>
 
-void write_color(std::ostream& out, Color pixel_color, int samples_per_pixel);
\ No newline at end of file
+void write_color(std::ostream& out, Color pixel_color, int samples_per_pixel);
+
+// Average, gamma-correct and quantize one pixel to 8-bit RGB
+void color_to_rgb8(Color pixel_color, int samples_per_pixel, unsigned char rgb[3]);
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// NUMA node (an index into NumaTopology) the calling thread is pinned to;
+// 0 for threads that were never pinned
+inline thread_local int thread_numa_node = 0;
+
+// CPUs this process may run on, grouped by NUMA node, read from
+// /sys/devices/system/node. Nodes without such CPUs are left out. Machines
+// without NUMA information report one node holding every allowed CPU.
+struct NumaTopology {
+    std::vector<std::vector<int>> node_cpus;   // CPU ids per node
+    std::vector<int> node_ids;                 // Kernel node id per node, for memory binding
+    
+    int node_count() const { return static_cast<int>(node_cpus.size()); }
+    int cpu_count() const;
+    
+    // Detected on first use
+    static const NumaTopology& get();
+};
+
+// Restrict the calling thread to cpus and record node as its NUMA node.
+// Returns false if the affinity could not be set.
+bool pin_current_thread(const std::vector<int>& cpus, int node);
+
+// CPUs the calling thread may currently run on
+std::vector<int> current_thread_cpus();
+
+// Move the pages of [address, address + bytes) to node and keep them there.
+// Only whole pages inside the range are affected. Returns false if the
+// kernel refused or NUMA is not supported.
+bool bind_memory_to_node(const void* address, size_t bytes, int node);
+
+// Run task on a new thread pinned to node's CPUs and wait for it, so that
+// memory the task first touches is allocated on that node. Exceptions from
+// task are rethrown.
+void run_on_node(int node, const std::function<void()>& task);
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Timeline recorder that writes Chrome trace-event JSON, viewable in
+// chrome://tracing or ui.perfetto.dev. Recording is off until start() is
+// called; while off, a TraceScope costs one relaxed load. Each thread
+// appends to its own buffer, so recording takes no locks after a thread's
+// first event.
+class Tracer {
+public:
+    // Begin recording; timestamps in the file are relative to this call
+    static void start();
+    
+    static bool enabled() { return active.load(std::memory_order_relaxed); }
+    
+    // Label the calling thread's track in the viewer
+    static void set_thread_name(const std::string& name);
+    
+    // Record a span [begin_ns, end_ns) on the calling thread. Names and
+    // categories must be string literals. tile_x/tile_y, when not negative,
+    // are shown as the span's arguments.
+    static void record(const char* name, const char* category, int64_t begin_ns, int64_t end_ns,
+                       int tile_x = -1, int tile_y = -1);
+    
+    // Write everything recorded so far. Call when no other thread is
+    // recording; throws std::runtime_error if the file cannot be written.
+    static void write(const std::string& path);
+    
+    static int64_t now_ns();
+
+private:
+    static std::atomic<bool> active;
+};
+
+// Records the lifetime of the scope as a span on the calling thread
+class TraceScope {
+public:
+    explicit TraceScope(const char* name, const char* category = "phase", int tile_x = -1, int tile_y = -1)
+        : name(name), category(category), tile_x(tile_x), tile_y(tile_y),
+          begin_ns(Tracer::enabled() ? Tracer::now_ns() : -1) {}
+    
+    ~TraceScope() {
+        if (begin_ns >= 0) {
+            Tracer::record(name, category, begin_ns, Tracer::now_ns(), tile_x, tile_y);
+        }
+    }
+    
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* name;
+    const char* category;
+    int tile_x;
+    int tile_y;
+    int64_t begin_ns;
+};
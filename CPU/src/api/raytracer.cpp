@@ -0,0 +1,453 @@
+#include "api/raytracer.h"
+#include "core/scene_arena.h"
+#include "geometry/plane.h"
+#include "geometry/sphere.h"
+#include "materials/diffuse_light.h"
+#include "materials/lambertian.h"
+#include "rendering/renderer.h"
+#include "scenes/scene_registry.h"
+#include "simd/kernels.h"
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+thread_local std::string last_error;
+
+rt_status fail(rt_status status, const std::string& message) {
+    last_error = message;
+    return status;
+}
+
+struct MaterialDesc {
+    bool emissive;
+    Color color;
+};
+
+struct PrimitiveDesc {
+    bool plane;
+    Point3 point;       // Sphere center or a point on the plane
+    Vec3 normal;
+    float radius;
+    int material;
+};
+
+// Scene assembled through the API. Only descriptions are kept until
+// rt_scene_build, which creates the objects in the render arena.
+class ApiScene : public Scene {
+public:
+    std::vector<MaterialDesc> materials;
+    std::vector<PrimitiveDesc> primitives;
+    
+    std::vector<std::shared_ptr<Hittable>> create_objects(SceneArena& arena) override {
+        std::vector<std::shared_ptr<Material>> created;
+        created.reserve(materials.size());
+        for (const MaterialDesc& desc : materials) {
+            if (desc.emissive) {
+                created.push_back(arena.make<DiffuseLight>(desc.color));
+            } else {
+                created.push_back(arena.make<Lambertian>(desc.color));
+            }
+        }
+        
+        std::vector<std::shared_ptr<Hittable>> objects;
+        objects.reserve(primitives.size());
+        for (const PrimitiveDesc& desc : primitives) {
+            if (desc.plane) {
+                objects.push_back(arena.make<Plane>(desc.point, desc.normal, created[desc.material]));
+            } else {
+                objects.push_back(arena.make<Sphere>(desc.point, desc.radius, created[desc.material]));
+            }
+        }
+        return objects;
+    }
+    
+    SceneConfig get_config() override { return SceneConfig(); }
+    const char* get_name() override { return "API scene"; }
+};
+
+bool finite(float value) {
+    return std::isfinite(value);
+}
+
+Vec3 to_vec3(const float v[3]) {
+    return Vec3(v[0], v[1], v[2]);
+}
+
+void from_vec3(const Vec3& v, float out[3]) {
+    out[0] = v.x;
+    out[1] = v.y;
+    out[2] = v.z;
+}
+
+// Thread pools left idle by finished renders, by requested thread count, so
+// that hosts rendering region by region do not start threads on every call.
+// A render takes a pool out for its duration; concurrent renders never share one.
+class PoolCache {
+public:
+    std::unique_ptr<ThreadPool> acquire(int threads) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto found = idle.find(threads);
+            if (found != idle.end()) {
+                std::unique_ptr<ThreadPool> pool = std::move(found->second);
+                idle.erase(found);
+                return pool;
+            }
+        }
+        return std::make_unique<ThreadPool>(threads);
+    }
+    
+    void release(int threads, std::unique_ptr<ThreadPool> pool) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (idle.size() < MAX_IDLE_POOLS) {
+            idle.emplace(threads, std::move(pool));
+        }
+    }
+
+private:
+    static const size_t MAX_IDLE_POOLS = 4;
+    std::mutex mutex;
+    std::multimap<int, std::unique_ptr<ThreadPool>> idle;
+};
+
+PoolCache& pool_cache() {
+    static PoolCache cache;
+    return cache;
+}
+
+// A pool borrowed from the cache for one render
+struct PoolLease {
+    int threads;
+    std::unique_ptr<ThreadPool> pool;
+    
+    explicit PoolLease(int threads) : threads(threads), pool(pool_cache().acquire(threads)) {}
+    ~PoolLease() { pool_cache().release(threads, std::move(pool)); }
+};
+
+// Run body, turning any exception into RT_ERROR_INTERNAL
+template <typename Body>
+rt_status guarded(Body body) {
+    try {
+        last_error.clear();
+        return body();
+    } catch (const std::exception& e) {
+        return fail(RT_ERROR_INTERNAL, e.what());
+    } catch (...) {
+        return fail(RT_ERROR_INTERNAL, "unknown error");
+    }
+}
+
+}
+
+struct rt_scene {
+    std::unique_ptr<Scene> source;
+    ApiScene* editable;     // Same object as source for API scenes, nullptr for built-ins
+    SceneConfig config;     // Camera and background
+    RenderWorld world;
+    bool built;
+};
+
+extern "C" {
+
+uint32_t rt_api_version(void) {
+    return RT_API_VERSION;
+}
+
+const char* rt_last_error(void) {
+    return last_error.c_str();
+}
+
+rt_scene* rt_scene_create(void) {
+    try {
+        auto scene = std::make_unique<rt_scene>();
+        auto source = std::make_unique<ApiScene>();
+        scene->editable = source.get();
+        scene->config = source->get_config();
+        scene->source = std::move(source);
+        scene->built = false;
+        return scene.release();
+    } catch (const std::exception& e) {
+        fail(RT_ERROR_INTERNAL, e.what());
+        return nullptr;
+    }
+}
+
+rt_scene* rt_scene_create_builtin(const char* name) {
+    if (!name) {
+        fail(RT_ERROR_INVALID_ARGUMENT, "scene name is NULL");
+        return nullptr;
+    }
+    try {
+        std::unique_ptr<Scene> source = create_scene(name);
+        if (!source) {
+            fail(RT_ERROR_INVALID_ARGUMENT, std::string("unknown scene: ") + name + " (known: " + scene_names() + ")");
+            return nullptr;
+        }
+        auto scene = std::make_unique<rt_scene>();
+        scene->editable = nullptr;
+        scene->config = source->get_config();
+        scene->source = std::move(source);
+        scene->built = false;
+        return scene.release();
+    } catch (const std::exception& e) {
+        fail(RT_ERROR_INTERNAL, e.what());
+        return nullptr;
+    }
+}
+
+void rt_scene_destroy(rt_scene* scene) {
+    delete scene;
+}
+
+static rt_status add_material(rt_scene* scene, bool emissive, float r, float g, float b, int* material_id) {
+    if (!scene || !material_id) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "scene or material_id is NULL");
+    }
+    if (!scene->editable || scene->built) {
+        return fail(RT_ERROR_INVALID_STATE, "scene cannot be edited");
+    }
+    if (!finite(r) || !finite(g) || !finite(b) || r < 0.0f || g < 0.0f || b < 0.0f) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "color components must be finite and non-negative");
+    }
+    return guarded([&] {
+        scene->editable->materials.push_back({emissive, Color(r, g, b)});
+        *material_id = static_cast<int>(scene->editable->materials.size()) - 1;
+        return RT_OK;
+    });
+}
+
+rt_status rt_scene_add_lambertian(rt_scene* scene, float r, float g, float b, int* material_id) {
+    return add_material(scene, false, r, g, b, material_id);
+}
+
+rt_status rt_scene_add_diffuse_light(rt_scene* scene, float r, float g, float b, int* material_id) {
+    return add_material(scene, true, r, g, b, material_id);
+}
+
+static rt_status add_primitive(rt_scene* scene, const PrimitiveDesc& desc) {
+    if (!scene) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "scene is NULL");
+    }
+    if (!scene->editable || scene->built) {
+        return fail(RT_ERROR_INVALID_STATE, "scene cannot be edited");
+    }
+    if (desc.material < 0 || desc.material >= static_cast<int>(scene->editable->materials.size())) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "no material with id " + std::to_string(desc.material));
+    }
+    return guarded([&] {
+        scene->editable->primitives.push_back(desc);
+        return RT_OK;
+    });
+}
+
+rt_status rt_scene_add_sphere(rt_scene* scene, float x, float y, float z, float radius, int material_id) {
+    if (!finite(x) || !finite(y) || !finite(z) || !finite(radius) || radius <= 0.0f) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "sphere needs a finite center and a positive radius");
+    }
+    return add_primitive(scene, {false, Point3(x, y, z), Vec3(0, 0, 0), radius, material_id});
+}
+
+rt_status rt_scene_add_plane(rt_scene* scene, const float point[3], const float normal[3], int material_id) {
+    if (!point || !normal) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "point or normal is NULL");
+    }
+    Vec3 n = to_vec3(normal);
+    if (!finite(point[0]) || !finite(point[1]) || !finite(point[2]) || !(n.length_squared() > 0.0f)) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "plane needs a finite point and a nonzero normal");
+    }
+    return add_primitive(scene, {true, to_vec3(point), n, 0.0f, material_id});
+}
+
+rt_status rt_scene_default_settings(const rt_scene* scene, rt_render_settings* settings) {
+    if (!scene || !settings) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "scene or settings is NULL");
+    }
+    settings->image_width = scene->config.image_width;
+    settings->image_height = scene->config.get_image_height();
+    settings->samples_per_pixel = scene->config.samples_per_pixel;
+    settings->max_depth = scene->config.max_depth;
+    settings->seed = 0;
+    settings->threads = 0;
+    return RT_OK;
+}
+
+rt_status rt_scene_set_camera(rt_scene* scene, const rt_camera* camera) {
+    if (!scene || !camera) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "scene or camera is NULL");
+    }
+    if (!(camera->fov_degrees > 0.0f && camera->fov_degrees < 180.0f)) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "fov_degrees must be in (0, 180)");
+    }
+    scene->config.camera_pos = to_vec3(camera->position);
+    scene->config.camera_target = to_vec3(camera->target);
+    scene->config.camera_up = to_vec3(camera->up);
+    scene->config.camera_fov = camera->fov_degrees;
+    return RT_OK;
+}
+
+rt_status rt_scene_get_camera(const rt_scene* scene, rt_camera* camera) {
+    if (!scene || !camera) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "scene or camera is NULL");
+    }
+    from_vec3(scene->config.camera_pos, camera->position);
+    from_vec3(scene->config.camera_target, camera->target);
+    from_vec3(scene->config.camera_up, camera->up);
+    camera->fov_degrees = scene->config.camera_fov;
+    return RT_OK;
+}
+
+rt_status rt_scene_set_background(rt_scene* scene, int sky, float r, float g, float b) {
+    if (!scene) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "scene is NULL");
+    }
+    scene->config.sky = sky != 0;
+    scene->config.background = Color(r, g, b);
+    return RT_OK;
+}
+
+rt_status rt_scene_build(rt_scene* scene, rt_accelerator accelerator) {
+    if (!scene) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "scene is NULL");
+    }
+    if (scene->built) {
+        return fail(RT_ERROR_INVALID_STATE, "scene is already built");
+    }
+    AcceleratorType type;
+    switch (accelerator) {
+        case RT_ACCELERATOR_LIST: type = AcceleratorType::List; break;
+        case RT_ACCELERATOR_KDTREE: type = AcceleratorType::KDTree; break;
+        case RT_ACCELERATOR_GRID: type = AcceleratorType::Grid; break;
+        case RT_ACCELERATOR_KDTREE_QUANTIZED16: type = AcceleratorType::KDTreeQuantized16; break;
+        case RT_ACCELERATOR_KDTREE_QUANTIZED8: type = AcceleratorType::KDTreeQuantized8; break;
+        default: return fail(RT_ERROR_INVALID_ARGUMENT, "unknown accelerator");
+    }
+    return guarded([&] {
+        scene->world = Renderer::build_world(*scene->source, type, true);
+        scene->built = true;
+        return RT_OK;
+    });
+}
+
+rt_status rt_render(const rt_scene* scene,
+                    const rt_render_settings* settings,
+                    const rt_region* region,
+                    rt_pixel_format format,
+                    void* pixels,
+                    size_t row_stride,
+                    rt_progress_fn progress,
+                    rt_cancel_fn cancel,
+                    void* user_data) {
+    if (!scene || !settings || !pixels) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "scene, settings or pixels is NULL");
+    }
+    if (!scene->built) {
+        return fail(RT_ERROR_INVALID_STATE, "scene has not been built");
+    }
+    if (settings->image_width <= 1 || settings->image_height <= 1 ||
+        settings->samples_per_pixel <= 0 || settings->max_depth <= 0 || settings->threads < 0) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "invalid render settings");
+    }
+    if (format != RT_PIXEL_RGB8 && format != RT_PIXEL_RGB_FLOAT) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "unknown pixel format");
+    }
+    
+    rt_region area = region ? *region : rt_region{0, 0, settings->image_width, settings->image_height};
+    if (area.x < 0 || area.y < 0 || area.width <= 0 || area.height <= 0 ||
+        area.x + area.width > settings->image_width || area.y + area.height > settings->image_height) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "region lies outside the image");
+    }
+    size_t pixel_size = format == RT_PIXEL_RGB8 ? 3 : 3 * sizeof(float);
+    if (row_stride < pixel_size * area.width) {
+        return fail(RT_ERROR_INVALID_ARGUMENT, "row_stride is smaller than a row of the region");
+    }
+    
+    return guarded([&] {
+        SceneConfig config = scene->config;
+        config.image_width = settings->image_width;
+        config.aspect_ratio = static_cast<float>(settings->image_width) / settings->image_height;
+        config.samples_per_pixel = settings->samples_per_pixel;
+        config.max_depth = settings->max_depth;
+        
+        RenderOptions options;
+        options.seed = settings->seed;
+        
+        Camera cam(config.camera_pos, config.camera_target, config.camera_up,
+                   config.camera_fov, config.aspect_ratio);
+        Framebuffer framebuffer(area.width, area.height, area.x, area.y,
+                                settings->image_width, settings->image_height);
+        
+        std::vector<Tile> tiles = Renderer::make_tiles(area.width, area.height);
+        for (Tile& tile : tiles) {
+            tile.x0 += area.x;
+            tile.x1 += area.x;
+            tile.y0 += area.y;
+            tile.y1 += area.y;
+        }
+        
+        // Callbacks are serialized so the caller's code never runs concurrently
+        std::mutex callback_mutex;
+        std::atomic<bool> cancelled(false);
+        int tiles_done = 0;
+        std::vector<char> finished(tiles.size(), 0);
+        
+        PoolLease lease(settings->threads);
+        lease.pool->parallel_for(static_cast<int>(tiles.size()), [&](int t) {
+            if (cancelled) {
+                return;
+            }
+            if (cancel) {
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                if (cancel(user_data)) {
+                    cancelled = true;
+                    return;
+                }
+            }
+            
+            Renderer::render_tile(scene->world, cam, config, options, framebuffer, tiles[t],
+                                  0, config.samples_per_pixel);
+            finished[t] = 1;
+            
+            if (progress) {
+                std::lock_guard<std::mutex> lock(callback_mutex);
+                tiles_done++;
+                progress(static_cast<float>(tiles_done) / tiles.size(), user_data);
+            }
+        });
+        
+        // Copy out the finished tiles row by row, honoring the caller's
+        // stride; after a cancel the others keep what the buffer held
+        const SimdKernels& kernels = simd_kernels();
+        float scale = 1.0f / config.samples_per_pixel;
+        unsigned char* out = static_cast<unsigned char*>(pixels);
+        for (size_t t = 0; t < tiles.size(); t++) {
+            if (!finished[t]) {
+                continue;
+            }
+            const Tile& tile = tiles[t];
+            size_t row_values = 3 * static_cast<size_t>(tile.x1 - tile.x0);
+            for (int y = tile.y0; y < tile.y1; y++) {
+                const float* sums = &framebuffer.pixels[framebuffer.index(tile.x0, y)].x;
+                unsigned char* destination = out + (y - area.y) * row_stride + (tile.x0 - area.x) * pixel_size;
+                if (format == RT_PIXEL_RGB8) {
+                    kernels.tonemap_rgb8(sums, row_values, scale, destination);
+                } else {
+                    float* values = reinterpret_cast<float*>(destination);
+                    for (size_t i = 0; i < row_values; i++) {
+                        values[i] = sums[i] * scale;
+                    }
+                }
+            }
+        }
+        
+        return cancelled ? fail(RT_ERROR_CANCELLED, "render cancelled") : RT_OK;
+    });
+}
+
+}
@@ -0,0 +1,18 @@
+#include "core/hittable.h"
+#include "geometry/instance.h"
+
+bool Hittable::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
+    Intersection isect;
+    if (!intersect(ray, t_min, t_max, isect)) {
+        return false;
+    }
+    
+    if (isect.instance) {
+        isect.instance->surface_interaction(ray, isect, rec);
+    } else {
+        isect.primitive->surface_interaction(ray, isect, rec);
+    }
+    return true;
+}
+
+void Hittable::surface_interaction(const Ray&, const Intersection&, HitRecord&) const {}
@@ -1,30 +1,72 @@
 #include "core/hittable_list.h"
 #include "geometry/bounding_box.h"
+#include "simd/kernels.h"
+#include <algorithm>
 
 void HittableList::add(std::shared_ptr<Hittable> object) {
+    BoundingBox box = object->bounding_box();
+    bounds[0].push_back(box.min.x);
+    bounds[1].push_back(box.min.y);
+    bounds[2].push_back(box.min.z);
+    bounds[3].push_back(box.max.x);
+    bounds[4].push_back(box.max.y);
+    bounds[5].push_back(box.max.z);
     objects.push_back(object);
 }
 
 void HittableList::clear() {
     objects.clear();
+    for (auto& axis_bounds : bounds) {
+        axis_bounds.clear();
+    }
 }
 
-bool HittableList::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
-    HitRecord temp_rec;
+bool HittableList::intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const {
+    const SimdKernels& kernels = simd_kernels();
+    KernelRay kernel_ray(ray);
+    uint8_t box_hits[BATCH];
+    
     bool hit_anything = false;
     float closest_so_far = t_max;
     
-    for (const auto& object : objects) {
-        if (object->hit(ray, t_min, closest_so_far, temp_rec)) {
-            hit_anything = true;
-            closest_so_far = temp_rec.t;
-            rec = temp_rec;
+    for (size_t first = 0; first < objects.size(); first += BATCH) {
+        size_t count = std::min(BATCH, objects.size() - first);
+        BoxArrays boxes = {{bounds[0].data() + first, bounds[1].data() + first, bounds[2].data() + first,
+                            bounds[3].data() + first, bounds[4].data() + first, bounds[5].data() + first}};
+        kernels.ray_boxes(boxes, count, kernel_ray, t_min, closest_so_far, box_hits);
+        
+        // Each successful test overwrites isect with a closer hit
+        for (size_t i = 0; i < count; i++) {
+            if (box_hits[i] && objects[first + i]->intersect(ray, t_min, closest_so_far, isect)) {
+                hit_anything = true;
+                closest_so_far = isect.t;
+            }
         }
     }
     
     return hit_anything;
 }
 
+bool HittableList::occluded(const Ray& ray, float t_min, float t_max) const {
+    const SimdKernels& kernels = simd_kernels();
+    KernelRay kernel_ray(ray);
+    uint8_t box_hits[BATCH];
+    
+    for (size_t first = 0; first < objects.size(); first += BATCH) {
+        size_t count = std::min(BATCH, objects.size() - first);
+        BoxArrays boxes = {{bounds[0].data() + first, bounds[1].data() + first, bounds[2].data() + first,
+                            bounds[3].data() + first, bounds[4].data() + first, bounds[5].data() + first}};
+        kernels.ray_boxes(boxes, count, kernel_ray, t_min, t_max, box_hits);
+        
+        for (size_t i = 0; i < count; i++) {
+            if (box_hits[i] && objects[first + i]->occluded(ray, t_min, t_max)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 BoundingBox HittableList::bounding_box() const {
     if (objects.empty()) return BoundingBox();
     
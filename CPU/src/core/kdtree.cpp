@@ -1,238 +1,505 @@
 #include "core/kdtree.h"
+#include "core/scene_arena.h"
+#include "core/traversal_stats.h"
 #include "geometry/bounding_box.h"
+#include "geometry/sphere.h"
 #include "math/ray.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <limits>
 
 // KDNode implementation
-KDNode::KDNode() : axis(0), split_pos(0.0f), is_leaf(true) {}
+KDNode::KDNode()
+    : objects(nullptr), object_count(0), left(nullptr), right(nullptr),
+      axis(0), split_pos(0.0f), is_leaf(true) {}
+
+namespace {
+
+inline float axis_value(const Point3& p, int axis) {
+    return axis == 0 ? p.x : (axis == 1 ? p.y : p.z);
+}
+
+const char* format_name(KDNodeFormat format) {
+    switch (format) {
+        case KDNodeFormat::Full: return "full-precision";
+        case KDNodeFormat::Quantized16: return "16-bit quantized";
+        case KDNodeFormat::Quantized8: return "8-bit quantized";
+    }
+    return "unknown";
+}
+
+// The children's boxes, decoded from the box of the node holding them. Lower
+// bounds count steps up from the parent's min and upper bounds count down
+// from its max, so the first and last steps land exactly on the parent's faces.
+// Building and traversal both decode through here so they agree to the bit.
+template <typename Q>
+inline void decode_children(const QuantizedKDNode<Q>& node, const BoundingBox& box,
+                            BoundingBox& left, BoundingBox& right) {
+    const float max_step = std::numeric_limits<Q>::max();
+    const float box_min[3] = {box.min.x, box.min.y, box.min.z};
+    const float box_max[3] = {box.max.x, box.max.y, box.max.z};
+    
+    float lo[2][3], hi[2][3];
+    for (int axis = 0; axis < 3; axis++) {
+        float step = (box_max[axis] - box_min[axis]) * (1.0f / max_step);
+        for (int c = 0; c < 2; c++) {
+            lo[c][axis] = box_min[axis] + node.lo[c][axis] * step;
+            hi[c][axis] = box_max[axis] - (max_step - node.hi[c][axis]) * step;
+        }
+    }
+    left.min.x = lo[0][0]; left.min.y = lo[0][1]; left.min.z = lo[0][2];
+    left.max.x = hi[0][0]; left.max.y = hi[0][1]; left.max.z = hi[0][2];
+    right.min.x = lo[1][0]; right.min.y = lo[1][1]; right.min.z = lo[1][2];
+    right.max.x = hi[1][0]; right.max.y = hi[1][1]; right.max.z = hi[1][2];
+}
+
+template <typename Q>
+BoundingBox decode_child(const QuantizedKDNode<Q>& node, int c, const BoundingBox& box) {
+    BoundingBox left, right;
+    decode_children(node, box, left, right);
+    return c == 0 ? left : right;
+}
+
+// Store child c's box relative to box, rounded outward so the decoded box
+// encloses it. child must lie inside box.
+template <typename Q>
+void encode_child(QuantizedKDNode<Q>& node, int c, const BoundingBox& child, const BoundingBox& box) {
+    const int max_step = std::numeric_limits<Q>::max();
+    for (int axis = 0; axis < 3; axis++) {
+        float box_min = axis_value(box.min, axis);
+        float extent = axis_value(box.max, axis) - box_min;
+        float scale = extent > 0.0f ? max_step / extent : 0.0f;
+        
+        float lo = std::floor((axis_value(child.min, axis) - box_min) * scale);
+        float hi = std::ceil((axis_value(child.max, axis) - box_min) * scale);
+        node.lo[c][axis] = static_cast<Q>(std::min(std::max(lo, 0.0f), static_cast<float>(max_step)));
+        node.hi[c][axis] = static_cast<Q>(std::min(std::max(hi, 0.0f), static_cast<float>(max_step)));
+    }
+    
+    // Rounding in the decode can still land a face just inside the exact box;
+    // widen by a step until it does not. Steps 0 and max_step decode exactly.
+    for (int axis = 0; axis < 3; axis++) {
+        while (node.lo[c][axis] > 0 &&
+               axis_value(decode_child(node, c, box).min, axis) > axis_value(child.min, axis)) {
+            node.lo[c][axis]--;
+        }
+        while (node.hi[c][axis] < max_step &&
+               axis_value(decode_child(node, c, box).max, axis) < axis_value(child.max, axis)) {
+            node.hi[c][axis]++;
+        }
+    }
+}
+
+bool is_finite(const BoundingBox& box) {
+    return std::isfinite(box.min.x) && std::isfinite(box.min.y) && std::isfinite(box.min.z) &&
+           std::isfinite(box.max.x) && std::isfinite(box.max.y) && std::isfinite(box.max.z);
+}
+
+// Leaf tests shared by both node formats; each hit narrows the range for the rest
+bool intersect_leaf(const SpherePacket& spheres, const Hittable* const* objects, int object_count,
+                    const Ray& ray, float t_min, float t_max, Intersection& isect) {
+    bool hit_anything = spheres.intersect(ray, t_min, t_max, isect);
+    float closest_so_far = hit_anything ? isect.t : t_max;
+    
+    for (int i = 0; i < object_count; i++) {
+        if (objects[i]->intersect(ray, t_min, closest_so_far, isect)) {
+            hit_anything = true;
+            closest_so_far = isect.t;
+        }
+    }
+    return hit_anything;
+}
+
+bool occluded_leaf(const SpherePacket& spheres, const Hittable* const* objects, int object_count,
+                   const Ray& ray, float t_min, float t_max) {
+    if (spheres.occluded(ray, t_min, t_max)) {
+        return true;
+    }
+    for (int i = 0; i < object_count; i++) {
+        if (objects[i]->occluded(ray, t_min, t_max)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
 
 // KDTree implementation
-KDTree::KDTree() : root(nullptr) {}
+KDTree::KDTree(KDNodeFormat format)
+    : format(format), root(nullptr), node_count(0), max_depth(0), arena(nullptr), node_arena(nullptr),
+      nodes16(nullptr), nodes8(nullptr), leaves(nullptr), root_ref(0), interior_count(0), leaf_count(0) {}
 
-void KDTree::build(const std::vector<std::shared_ptr<Hittable>>& objects) {
-    if (objects.empty()) {
-        root.reset();
-        all_objects.clear();
-        return;
+KDTree::~KDTree() = default;
+
+void KDTree::build(const std::vector<std::shared_ptr<Hittable>>& objects, SceneArena* target_arena,
+                   bool quiet) {
+    // A private arena is replaced wholesale, which frees the old tree in O(1)
+    root = nullptr;
+    bounds = BoundingBox();
+    node_count = max_depth = 0;
+    nodes16 = nullptr;
+    nodes8 = nullptr;
+    leaves = nullptr;
+    interior_count = leaf_count = 0;
+    if (target_arena) {
+        own_arena.reset();
+        arena = target_arena;
+    } else {
+        own_arena = std::make_unique<SceneArena>();
+        arena = own_arena.get();
     }
     
     // Store all objects for future reference
     all_objects = objects;
+    if (objects.empty()) {
+        return;
+    }
     
-    // Calculate overall bounding box
+    // Boxes and centroids are computed once; the build partitions this array in place
+    std::vector<BuildItem> items;
+    items.reserve(objects.size());
     BoundingBox overall_bbox = objects[0]->bounding_box();
-    for (size_t i = 1; i < objects.size(); ++i) {
-        overall_bbox = surrounding_box(overall_bbox, objects[i]->bounding_box());
+    for (const auto& obj : objects) {
+        BoundingBox bbox = obj->bounding_box();
+        items.push_back({obj.get(), bbox, bbox.center()});
+        overall_bbox = surrounding_box(overall_bbox, bbox);
+    }
+    
+    BuildScratch scratch;
+    scratch.split_values.reserve(objects.size());
+    bounds = overall_bbox;
+    
+    // Quantized boxes are relative to a finite parent box
+    // This build only: the configured format still applies to later builds
+    KDNodeFormat build_format = format;
+    if (build_format != KDNodeFormat::Full && !is_finite(bounds)) {
+        if (!quiet) std::cerr << "KD-Tree: objects are unbounded, keeping full-precision nodes\n";
+        build_format = KDNodeFormat::Full;
     }
     
-    // Make a copy of objects for partitioning
-    auto objects_copy = objects;
+    // Quantized formats build KDNodes in a scratch arena and keep only the
+    // compressed copy; leaf contents go to the tree's arena either way
+    std::unique_ptr<SceneArena> scratch_nodes;
+    node_arena = arena;
+    if (build_format != KDNodeFormat::Full) {
+        scratch_nodes = std::make_unique<SceneArena>();
+        node_arena = scratch_nodes.get();
+    }
     
     // Build the tree recursively
-    root = build_recursive(objects_copy, overall_bbox, 0);
+    KDNode* tree = build_recursive(items.data(), items.data() + items.size(), overall_bbox, 0, scratch);
+    node_count = count_nodes(tree);
+    max_depth = calculate_max_depth(tree, 0);
     
+    if (build_format == KDNodeFormat::Quantized16) {
+        nodes16 = quantize_tree<uint16_t>(tree);
+    } else if (build_format == KDNodeFormat::Quantized8) {
+        nodes8 = quantize_tree<uint8_t>(tree);
+    } else {
+        root = tree;
+    }
+    node_arena = nullptr;
+    
+    if (quiet) return;
     std::cerr << "KD-Tree built with " << get_node_count() << " nodes, max depth: " 
-              << get_max_depth() << ", " << objects.size() << " objects\n";
+              << get_max_depth() << ", " << objects.size() << " objects, "
+              << get_node_bytes() / 1024 << " KB of " << format_name(build_format) << " nodes\n";
 }
 
-std::unique_ptr<KDNode> KDTree::build_recursive(
-    std::vector<std::shared_ptr<Hittable>>& objects, 
+KDNode* KDTree::build_recursive(
+    BuildItem* begin,
+    BuildItem* end,
     const BoundingBox& bbox, 
-    int depth) {
+    int depth,
+    BuildScratch& scratch) {
     
-    auto node = std::make_unique<KDNode>();
+    KDNode* node = node_arena->create<KDNode>();
     node->bbox = bbox;
+    size_t count = end - begin;
     
     // Check for leaf node conditions
-    if (objects.size() <= MIN_OBJECTS || depth >= MAX_DEPTH) {
-        node->objects = objects;
-        node->is_leaf = true;
+    if (count <= MIN_OBJECTS || depth >= MAX_DEPTH) {
+        make_leaf(node, begin, end, scratch);
         return node;
     }
     
-    // Choose split axis and position
-    int axis = depth % 3; 
-    float split_pos = find_split_position(objects, axis);
-    
-    node->axis = axis;
-    node->split_pos = split_pos;
-    node->is_leaf = false;
+    // Split along the longest axis of the node first; if every centroid lands
+    // on one side (e.g. spheres resting on a common plane), try the others
+    Vec3 extent = bbox.size();
+    int longest = (extent.x >= extent.y && extent.x >= extent.z) ? 0 : (extent.y >= extent.z ? 1 : 2);
     
-    // Partition objects
-    std::vector<std::shared_ptr<Hittable>> left_objects, right_objects;
-    partition_objects(objects, axis, split_pos, left_objects, right_objects);
+    int axis = longest;
+    float split_pos = 0.0f;
+    BuildItem* middle = begin;
+    for (int attempt = 0; attempt < 3; attempt++) {
+        axis = (longest + attempt) % 3;
+        split_pos = find_split_position(begin, end, axis, scratch.split_values);
+        
+        middle = std::partition(begin, end, [axis, split_pos](const BuildItem& item) {
+            return axis_value(item.centroid, axis) < split_pos;
+        });
+        if (middle != begin && middle != end) {
+            break;
+        }
+    }
     
-    // Handle edge cases where all objects end up on one side
-    if (left_objects.empty() || right_objects.empty()) {
-        node->objects = objects;
-        node->is_leaf = true;
+    // Handle edge cases where all objects end up on one side on every axis
+    if (middle == begin || middle == end) {
+        make_leaf(node, begin, end, scratch);
         return node;
     }
     
-    // Create child bounding boxes
-    BoundingBox left_bbox = bbox;
-    BoundingBox right_bbox = bbox;
+    node->axis = axis;
+    node->split_pos = split_pos;
+    node->is_leaf = false;
     
-    if (axis == 0) {
-        left_bbox.max.x = split_pos;
-        right_bbox.min.x = split_pos;
-    } else if (axis == 1) {
-        left_bbox.max.y = split_pos;
-        right_bbox.min.y = split_pos;
-    } else {
-        left_bbox.max.z = split_pos;
-        right_bbox.min.z = split_pos;
+    // Child boxes must enclose their objects: objects are assigned by centroid,
+    // so clipping the parent box at the split plane would cull their far halves
+    BoundingBox left_bbox = begin->bbox;
+    for (const BuildItem* item = begin + 1; item != middle; ++item) {
+        left_bbox = surrounding_box(left_bbox, item->bbox);
+    }
+    BoundingBox right_bbox = middle->bbox;
+    for (const BuildItem* item = middle + 1; item != end; ++item) {
+        right_bbox = surrounding_box(right_bbox, item->bbox);
     }
     
     // Recursively build children
-    node->left = build_recursive(left_objects, left_bbox, depth + 1);
-    node->right = build_recursive(right_objects, right_bbox, depth + 1);
+    node->left = build_recursive(begin, middle, left_bbox, depth + 1, scratch);
+    node->right = build_recursive(middle, end, right_bbox, depth + 1, scratch);
     
     return node;
 }
 
-float KDTree::find_split_position(const std::vector<std::shared_ptr<Hittable>>& objects, int axis) const {
-    // Find median centroid position along the chosen axis
-    std::vector<float> positions;
-    positions.reserve(objects.size());
+void KDTree::make_leaf(KDNode* node, const BuildItem* begin, const BuildItem* end, BuildScratch& scratch) {
+    node->is_leaf = true;
     
-    for (const auto& obj : objects) {
-        BoundingBox bbox = obj->bounding_box();
-        Point3 centroid = bbox.center();
-        
-        if (axis == 0) {
-            positions.push_back(centroid.x);
-        } else if (axis == 1) {
-            positions.push_back(centroid.y);
+    std::vector<const Sphere*>& spheres = scratch.spheres;
+    std::vector<const Hittable*>& others = scratch.others;
+    spheres.clear();
+    others.clear();
+    for (const BuildItem* item = begin; item != end; ++item) {
+        if (const Sphere* sphere = dynamic_cast<const Sphere*>(item->object)) {
+            spheres.push_back(sphere);
         } else {
-            positions.push_back(centroid.z);
+            others.push_back(item->object);
         }
     }
     
-    std::sort(positions.begin(), positions.end());
-    return positions[positions.size() / 2];
+    node->spheres.assign(spheres, *arena);
+    if (!others.empty()) {
+        const Hittable** objects = arena->allocate_array<const Hittable*>(others.size());
+        std::copy(others.begin(), others.end(), objects);
+        node->objects = objects;
+        node->object_count = static_cast<int>(others.size());
+    }
 }
 
-void KDTree::partition_objects(
-    std::vector<std::shared_ptr<Hittable>>& objects,
-    int axis,
-    float split_pos,
-    std::vector<std::shared_ptr<Hittable>>& left_objects,
-    std::vector<std::shared_ptr<Hittable>>& right_objects) const {
-    
-    for (const auto& obj : objects) {
-        BoundingBox bbox = obj->bounding_box();
-        Point3 centroid = bbox.center();
-        
-        float centroid_pos;
-        if (axis == 0) {
-            centroid_pos = centroid.x;
-        } else if (axis == 1) {
-            centroid_pos = centroid.y;
-        } else {
-            centroid_pos = centroid.z;
-        }
-        
-        if (centroid_pos < split_pos) {
-            left_objects.push_back(obj);
-        } else {
-            right_objects.push_back(obj);
-        }
+float KDTree::find_split_position(const BuildItem* begin, const BuildItem* end, int axis,
+                                  std::vector<float>& scratch) const {
+    // Find median centroid position along the chosen axis
+    scratch.clear();
+    for (const BuildItem* item = begin; item != end; ++item) {
+        scratch.push_back(axis_value(item->centroid, axis));
     }
+    
+    auto median = scratch.begin() + scratch.size() / 2;
+    std::nth_element(scratch.begin(), median, scratch.end());
+    return *median;
 }
 
-bool KDTree::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
+bool KDTree::intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const {
+    if (nodes16) {
+        return intersect_quantized(nodes16, root_ref, bounds, ray, t_min, t_max, isect);
+    }
+    if (nodes8) {
+        return intersect_quantized(nodes8, root_ref, bounds, ray, t_min, t_max, isect);
+    }
     if (!root) {
         return false;
     }
-    return hit_node(root.get(), ray, t_min, t_max, rec);
+    return intersect_node(root, ray, t_min, t_max, isect);
 }
 
-bool KDTree::hit_node(const KDNode* node, const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
+bool KDTree::intersect_node(const KDNode* node, const Ray& ray, float t_min, float t_max, Intersection& isect) const {
+    traversal_stats.nodes_visited++;
+    
     // Quick bounding box test
     if (!node->bbox.hit(ray, t_min, t_max)) {
         return false;
     }
     
     if (node->is_leaf) {
-        // Test all objects in this leaf
-        bool hit_anything = false;
-        float closest_so_far = t_max;
-        
-        for (const auto& object : node->objects) {
-            HitRecord temp_rec;
-            if (object->hit(ray, t_min, closest_so_far, temp_rec)) {
-                hit_anything = true;
-                closest_so_far = temp_rec.t;
-                rec = temp_rec;
-            }
-        }
-        return hit_anything;
+        return intersect_leaf(node->spheres, node->objects, node->object_count, ray, t_min, t_max, isect);
     }
     
-    // Interior node - test children
-    bool hit_left = false, hit_right = false;
-    HitRecord left_rec, right_rec;
+    // Interior node - a hit in the left child bounds the search of the right one
+    bool hit_left = node->left && intersect_node(node->left, ray, t_min, t_max, isect);
+    float right_max = hit_left ? isect.t : t_max;
+    bool hit_right = node->right && intersect_node(node->right, ray, t_min, right_max, isect);
     
-    if (node->left) {
-        hit_left = hit_node(node->left.get(), ray, t_min, t_max, left_rec);
+    return hit_left || hit_right;
+}
+
+bool KDTree::occluded(const Ray& ray, float t_min, float t_max) const {
+    if (nodes16) {
+        return occluded_quantized(nodes16, root_ref, bounds, ray, t_min, t_max);
+    }
+    if (nodes8) {
+        return occluded_quantized(nodes8, root_ref, bounds, ray, t_min, t_max);
     }
-    if (node->right) {
-        hit_right = hit_node(node->right.get(), ray, t_min, t_max, right_rec);
+    if (!root) {
+        return false;
+    }
+    return occluded_node(root, ray, t_min, t_max);
+}
+
+bool KDTree::occluded_node(const KDNode* node, const Ray& ray, float t_min, float t_max) const {
+    traversal_stats.nodes_visited++;
+    if (!node->bbox.hit(ray, t_min, t_max)) {
+        return false;
     }
     
-    // Return the closest hit
-    if (hit_left && hit_right) {
-        rec = (left_rec.t < right_rec.t) ? left_rec : right_rec;
-        return true;
-    } else if (hit_left) {
-        rec = left_rec;
-        return true;
-    } else if (hit_right) {
-        rec = right_rec;
-        return true;
+    if (node->is_leaf) {
+        return occluded_leaf(node->spheres, node->objects, node->object_count, ray, t_min, t_max);
     }
     
-    return false;
+    // Any hit will do, so the right subtree is skipped once the left one is blocked
+    return (node->left && occluded_node(node->left, ray, t_min, t_max)) ||
+           (node->right && occluded_node(node->right, ray, t_min, t_max));
 }
 
-BoundingBox KDTree::bounding_box() const {
-    if (!root) {
-        return BoundingBox();
+template <typename Q>
+bool KDTree::intersect_quantized(const QuantizedKDNode<Q>* nodes, uint32_t ref, const BoundingBox& box,
+                                 const Ray& ray, float t_min, float t_max, Intersection& isect) const {
+    traversal_stats.nodes_visited++;
+    if (!box.hit(ray, t_min, t_max)) {
+        return false;
+    }
+    
+    if (ref & QuantizedKDNode<Q>::LEAF_FLAG) {
+        const KDLeaf& leaf = leaves[ref & ~QuantizedKDNode<Q>::LEAF_FLAG];
+        return intersect_leaf(leaf.spheres, leaf.objects, leaf.object_count, ray, t_min, t_max, isect);
     }
-    return root->bbox;
+    
+    const QuantizedKDNode<Q>& node = nodes[ref];
+    BoundingBox left, right;
+    decode_children(node, box, left, right);
+    bool hit_left = intersect_quantized(nodes, node.child[0], left, ray, t_min, t_max, isect);
+    float right_max = hit_left ? isect.t : t_max;
+    bool hit_right = intersect_quantized(nodes, node.child[1], right, ray, t_min, right_max, isect);
+    
+    return hit_left || hit_right;
+}
+
+template <typename Q>
+bool KDTree::occluded_quantized(const QuantizedKDNode<Q>* nodes, uint32_t ref, const BoundingBox& box,
+                                const Ray& ray, float t_min, float t_max) const {
+    traversal_stats.nodes_visited++;
+    if (!box.hit(ray, t_min, t_max)) {
+        return false;
+    }
+    
+    if (ref & QuantizedKDNode<Q>::LEAF_FLAG) {
+        const KDLeaf& leaf = leaves[ref & ~QuantizedKDNode<Q>::LEAF_FLAG];
+        return occluded_leaf(leaf.spheres, leaf.objects, leaf.object_count, ray, t_min, t_max);
+    }
+    
+    const QuantizedKDNode<Q>& node = nodes[ref];
+    BoundingBox left, right;
+    decode_children(node, box, left, right);
+    return occluded_quantized(nodes, node.child[0], left, ray, t_min, t_max) ||
+           occluded_quantized(nodes, node.child[1], right, ray, t_min, t_max);
+}
+
+template <typename Q>
+const QuantizedKDNode<Q>* KDTree::quantize_tree(const KDNode* tree) {
+    // Every interior node has two children, so leaves outnumber them by one
+    interior_count = node_count / 2;
+    leaf_count = node_count - interior_count;
+    QuantizedKDNode<Q>* nodes = arena->allocate_array<QuantizedKDNode<Q>>(std::max(interior_count, 1));
+    KDLeaf* leaf_array = arena->allocate_array<KDLeaf>(leaf_count);
+    
+    int next_node = 0;
+    int next_leaf = 0;
+    root_ref = quantize_node(tree, bounds, nodes, next_node, leaf_array, next_leaf);
+    leaves = leaf_array;
+    return nodes;
+}
+
+template <typename Q>
+uint32_t KDTree::quantize_node(const KDNode* node, const BoundingBox& box, QuantizedKDNode<Q>* nodes,
+                               int& next_node, KDLeaf* leaf_array, int& next_leaf) {
+    if (node->is_leaf) {
+        new (&leaf_array[next_leaf]) KDLeaf{node->objects, node->object_count, node->spheres};
+        return QuantizedKDNode<Q>::LEAF_FLAG | static_cast<uint32_t>(next_leaf++);
+    }
+    
+    // Nodes are laid out depth-first, so a left child usually follows its parent.
+    // Children are encoded against the decoded box traversal will see, not the exact one.
+    int index = next_node++;
+    QuantizedKDNode<Q>& quantized = nodes[index];
+    encode_child(quantized, 0, node->left->bbox, box);
+    encode_child(quantized, 1, node->right->bbox, box);
+    quantized.child[0] = quantize_node(node->left, decode_child(quantized, 0, box), nodes, next_node, leaf_array, next_leaf);
+    quantized.child[1] = quantize_node(node->right, decode_child(quantized, 1, box), nodes, next_node, leaf_array, next_leaf);
+    return static_cast<uint32_t>(index);
+}
+
+BoundingBox KDTree::bounding_box() const {
+    return bounds;
 }
 
 void KDTree::add(std::shared_ptr<Hittable> object) {
     all_objects.push_back(object);
-    build(all_objects);  // Rebuild the entire tree
+    build(all_objects, own_arena ? nullptr : arena);  // Rebuild the entire tree
 }
 
 void KDTree::clear() {
-    root.reset();
+    root = nullptr;
+    bounds = BoundingBox();
+    node_count = max_depth = 0;
+    nodes16 = nullptr;
+    nodes8 = nullptr;
+    leaves = nullptr;
+    interior_count = leaf_count = 0;
+    own_arena.reset();
+    arena = nullptr;
     all_objects.clear();
 }
 
 int KDTree::get_node_count() const {
-    return count_nodes(root.get());
+    return node_count;
 }
 
 int KDTree::get_max_depth() const {
-    return calculate_max_depth(root.get(), 0);
+    return max_depth;
+}
+
+size_t KDTree::get_node_bytes() const {
+    // The node array that is set tells the format of the current tree
+    if (nodes16) {
+        return interior_count * sizeof(QuantizedKDNode<uint16_t>) + leaf_count * sizeof(KDLeaf);
+    }
+    if (nodes8) {
+        return interior_count * sizeof(QuantizedKDNode<uint8_t>) + leaf_count * sizeof(KDLeaf);
+    }
+    return node_count * sizeof(KDNode);
 }
 
 int KDTree::count_nodes(const KDNode* node) const {
     if (!node) return 0;
-    return 1 + count_nodes(node->left.get()) + count_nodes(node->right.get());
+    return 1 + count_nodes(node->left) + count_nodes(node->right);
 }
 
 int KDTree::calculate_max_depth(const KDNode* node, int current_depth) const {
     if (!node) return current_depth;
     if (node->is_leaf) return current_depth + 1;
     
-    int left_depth = calculate_max_depth(node->left.get(), current_depth + 1);
-    int right_depth = calculate_max_depth(node->right.get(), current_depth + 1);
+    int left_depth = calculate_max_depth(node->left, current_depth + 1);
+    int right_depth = calculate_max_depth(node->right, current_depth + 1);
     
     return std::max(left_depth, right_depth);
 }
\ No newline at end of file
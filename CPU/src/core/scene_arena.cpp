@@ -0,0 +1,20 @@
+#include "core/scene_arena.h"
+
+void* CountingResource::do_allocate(size_t size, size_t alignment) {
+    count++;
+    bytes += size;
+    return upstream->allocate(size, alignment);
+}
+
+void CountingResource::do_deallocate(void* p, size_t size, size_t alignment) {
+    upstream->deallocate(p, size, alignment);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+SceneArena::SceneArena(size_t initial_block_size)
+    : blocks(std::pmr::new_delete_resource()),
+      arena(initial_block_size, &blocks),
+      counted(&arena) {}
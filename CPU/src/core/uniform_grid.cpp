@@ -0,0 +1,228 @@
+#include "core/uniform_grid.h"
+#include "core/traversal_stats.h"
+#include "math/ray.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace {
+
+inline float component(const Vec3& v, int axis) {
+    return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+}
+
+}
+
+UniformGrid::UniformGrid() : resolution{0, 0, 0} {}
+
+void UniformGrid::build(const std::vector<std::shared_ptr<Hittable>>& objects, bool quiet) {
+    all_objects = objects;
+    cell_start.clear();
+    cell_objects.clear();
+    resolution[0] = resolution[1] = resolution[2] = 0;
+    if (objects.empty()) {
+        return;
+    }
+    
+    std::vector<BoundingBox> boxes;
+    boxes.reserve(objects.size());
+    bounds = objects[0]->bounding_box();
+    for (const auto& object : objects) {
+        boxes.push_back(object->bounding_box());
+        bounds = surrounding_box(bounds, boxes.back());
+    }
+    
+    choose_resolution(objects.size());
+    
+    // Two passes over the objects: count references per cell, then fill
+    int cell_count = get_cell_count();
+    cell_start.assign(cell_count + 1, 0);
+    
+    auto for_each_cell = [&](const BoundingBox& box, auto&& action) {
+        int x0 = cell_coordinate(box.min.x, 0), x1 = cell_coordinate(box.max.x, 0);
+        int y0 = cell_coordinate(box.min.y, 1), y1 = cell_coordinate(box.max.y, 1);
+        int z0 = cell_coordinate(box.min.z, 2), z1 = cell_coordinate(box.max.z, 2);
+        for (int z = z0; z <= z1; z++) {
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) {
+                    action(cell_index(x, y, z));
+                }
+            }
+        }
+    };
+    
+    for (const auto& box : boxes) {
+        for_each_cell(box, [&](int cell) { cell_start[cell + 1]++; });
+    }
+    for (int cell = 0; cell < cell_count; cell++) {
+        cell_start[cell + 1] += cell_start[cell];
+    }
+    
+    cell_objects.resize(cell_start[cell_count]);
+    std::vector<uint32_t> fill(cell_start.begin(), cell_start.end() - 1);
+    for (size_t i = 0; i < objects.size(); i++) {
+        const Hittable* object = objects[i].get();
+        for_each_cell(boxes[i], [&](int cell) { cell_objects[fill[cell]++] = object; });
+    }
+    
+    if (quiet) return;
+    std::cerr << "Uniform grid built with " << resolution[0] << "x" << resolution[1] << "x" << resolution[2]
+              << " cells, " << cell_objects.size() << " references, " << objects.size() << " objects\n";
+}
+
+void UniformGrid::choose_resolution(size_t object_count) {
+    // Cubical cells sized so the grid holds about DENSITY cells per object
+    Vec3 extent = bounds.size();
+    float max_extent = std::max(extent.x, std::max(extent.y, extent.z));
+    float volume = std::max(extent.x, max_extent * 1e-3f) *
+                   std::max(extent.y, max_extent * 1e-3f) *
+                   std::max(extent.z, max_extent * 1e-3f);
+    float cells_per_unit = std::cbrt(DENSITY * object_count / volume);
+    
+    for (int axis = 0; axis < 3; axis++) {
+        int cells = static_cast<int>(std::round(component(extent, axis) * cells_per_unit));
+        resolution[axis] = std::clamp(cells, 1, MAX_RESOLUTION);
+    }
+    
+    // Degenerate (flat) axes keep one cell of nonzero size
+    cell_size = Vec3(
+        std::max(extent.x, 1e-6f) / resolution[0],
+        std::max(extent.y, 1e-6f) / resolution[1],
+        std::max(extent.z, 1e-6f) / resolution[2]
+    );
+    inv_cell_size = Vec3(1.0f / cell_size.x, 1.0f / cell_size.y, 1.0f / cell_size.z);
+}
+
+int UniformGrid::cell_coordinate(float position, int axis) const {
+    float offset = (position - component(bounds.min, axis)) * component(inv_cell_size, axis);
+    return std::clamp(static_cast<int>(offset), 0, resolution[axis] - 1);
+}
+
+int UniformGrid::cell_index(int x, int y, int z) const {
+    return (z * resolution[1] + y) * resolution[0] + x;
+}
+
+template <typename Visit>
+void UniformGrid::traverse(const Ray& ray, float t_min, float t_max, Visit visit) const {
+    if (cell_objects.empty()) {
+        return;
+    }
+    
+    // Clip the ray to the grid bounds
+    float t_enter = t_min;
+    float t_exit = t_max;
+    for (int axis = 0; axis < 3; axis++) {
+        float inv_dir = 1.0f / component(ray.direction, axis);
+        float t0 = (component(bounds.min, axis) - component(ray.origin, axis)) * inv_dir;
+        float t1 = (component(bounds.max, axis) - component(ray.origin, axis)) * inv_dir;
+        if (inv_dir < 0.0f) {
+            std::swap(t0, t1);
+        }
+        t_enter = std::max(t_enter, t0);
+        t_exit = std::min(t_exit, t1);
+        if (t_exit < t_enter) {
+            return;
+        }
+    }
+    
+    // DDA setup: current cell, the t of the next boundary on each axis,
+    // and the t spacing between boundaries
+    Point3 entry = ray.at(t_enter);
+    int cell[3];
+    int step[3];
+    int end[3];
+    float t_next[3];
+    float t_delta[3];
+    const float infinity = std::numeric_limits<float>::infinity();
+    
+    for (int axis = 0; axis < 3; axis++) {
+        float origin = component(ray.origin, axis);
+        float dir = component(ray.direction, axis);
+        float size = component(cell_size, axis);
+        float grid_min = component(bounds.min, axis);
+        cell[axis] = cell_coordinate(component(entry, axis), axis);
+        
+        if (dir > 0.0f) {
+            step[axis] = 1;
+            end[axis] = resolution[axis];
+            t_next[axis] = (grid_min + (cell[axis] + 1) * size - origin) / dir;
+            t_delta[axis] = size / dir;
+        } else if (dir < 0.0f) {
+            step[axis] = -1;
+            end[axis] = -1;
+            t_next[axis] = (grid_min + cell[axis] * size - origin) / dir;
+            t_delta[axis] = -size / dir;
+        } else {
+            step[axis] = 0;
+            end[axis] = -1;
+            t_next[axis] = infinity;
+            t_delta[axis] = infinity;
+        }
+    }
+    
+    while (true) {
+        int axis = (t_next[0] < t_next[1])
+            ? (t_next[0] < t_next[2] ? 0 : 2)
+            : (t_next[1] < t_next[2] ? 1 : 2);
+        
+        int index = cell_index(cell[0], cell[1], cell[2]);
+        traversal_stats.nodes_visited++;
+        if (visit(cell_start[index], cell_start[index + 1], std::min(t_next[axis], t_exit))) {
+            return;
+        }
+        
+        if (t_next[axis] > t_exit) {
+            return;
+        }
+        cell[axis] += step[axis];
+        if (cell[axis] == end[axis]) {
+            return;
+        }
+        t_next[axis] += t_delta[axis];
+    }
+}
+
+bool UniformGrid::intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const {
+    bool hit_anything = false;
+    float closest_so_far = t_max;
+    
+    traverse(ray, t_min, t_max, [&](uint32_t first, uint32_t last, float t_cell_exit) {
+        for (uint32_t i = first; i < last; i++) {
+            if (cell_objects[i]->intersect(ray, t_min, closest_so_far, isect)) {
+                hit_anything = true;
+                closest_so_far = isect.t;
+            }
+        }
+        // Objects span cells, so a hit beyond this cell may still be beaten further along
+        return hit_anything && closest_so_far <= t_cell_exit;
+    });
+    return hit_anything;
+}
+
+bool UniformGrid::occluded(const Ray& ray, float t_min, float t_max) const {
+    bool blocked = false;
+    
+    traverse(ray, t_min, t_max, [&](uint32_t first, uint32_t last, float) {
+        for (uint32_t i = first; i < last; i++) {
+            if (cell_objects[i]->occluded(ray, t_min, t_max)) {
+                blocked = true;
+                return true;
+            }
+        }
+        return false;
+    });
+    return blocked;
+}
+
+BoundingBox UniformGrid::bounding_box() const {
+    return bounds;
+}
+
+int UniformGrid::get_cell_count() const {
+    return resolution[0] * resolution[1] * resolution[2];
+}
+
+size_t UniformGrid::get_reference_count() const {
+    return cell_objects.size();
+}
@@ -0,0 +1,22 @@
+#include "utils/allocation_counter.h"
+#include <cstdlib>
+#include <new>
+
+// Replacements for the global allocation functions; the array and nothrow
+// forms forward to these by default. Linked into the executable only, so
+// programs embedding the library keep their own allocator.
+void* operator new(std::size_t size) {
+    note_heap_allocation();
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
@@ -0,0 +1,46 @@
+#include "geometry/instance.h"
+#include "math/ray.h"
+
+Instance::Instance(std::shared_ptr<Hittable> object, const Transform& object_to_world)
+    : object(object), object_to_world(object_to_world), world_to_object(object_to_world.inverse()) {
+    
+    // Transform all eight corners of the object-space box and take their bounds
+    BoundingBox local_bbox = object->bounding_box();
+    for (int corner = 0; corner < 8; corner++) {
+        Point3 p(
+            (corner & 1) ? local_bbox.max.x : local_bbox.min.x,
+            (corner & 2) ? local_bbox.max.y : local_bbox.min.y,
+            (corner & 4) ? local_bbox.max.z : local_bbox.min.z
+        );
+        Point3 world_p = object_to_world.transform_point(p);
+        BoundingBox point_box(world_p, world_p);
+        world_bbox = (corner == 0) ? point_box : surrounding_box(world_bbox, point_box);
+    }
+}
+
+bool Instance::intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const {
+    // The direction is not renormalized, so t is the same in both spaces
+    Ray local_ray = world_to_object.transform_ray(ray);
+    
+    if (!object->intersect(local_ray, t_min, t_max, isect)) {
+        return false;
+    }
+    isect.instance = this;
+    return true;
+}
+
+void Instance::surface_interaction(const Ray& ray, const Intersection& isect, HitRecord& rec) const {
+    isect.primitive->surface_interaction(world_to_object.transform_ray(ray), isect, rec);
+    
+    // A linear map keeps the sign of dot(direction, normal), so front_face is unchanged
+    rec.point = ray.at(rec.t);
+    rec.normal = world_to_object.transform_normal(rec.normal).normalize();
+}
+
+bool Instance::occluded(const Ray& ray, float t_min, float t_max) const {
+    return object->occluded(world_to_object.transform_ray(ray), t_min, t_max);
+}
+
+BoundingBox Instance::bounding_box() const {
+    return world_bbox;
+}
@@ -0,0 +1,46 @@
+#include "geometry/plane.h"
+#include "core/traversal_stats.h"
+#include "materials/material.h"
+#include "math/ray.h"
+#include <limits>
+
+Plane::Plane(const Point3& point, const Vec3& normal, std::shared_ptr<Material> material)
+    : point(point), normal(normal.normalize()), material(material), offset(this->normal.dot(point)) {}
+
+float Plane::crossing(const Ray& ray) const {
+    return (offset - normal.dot(ray.origin)) / normal.dot(ray.direction);
+}
+
+bool Plane::intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const {
+    traversal_stats.primitive_tests++;
+    float t = crossing(ray);
+    
+    // Written so that NaN from a parallel ray fails the test
+    if (!(t >= t_min && t <= t_max)) {
+        return false;
+    }
+    
+    isect.t = t;
+    isect.primitive = this;
+    isect.instance = nullptr;
+    return true;
+}
+
+void Plane::surface_interaction(const Ray& ray, const Intersection& isect, HitRecord& rec) const {
+    rec.t = isect.t;
+    rec.point = ray.at(rec.t);
+    rec.set_face_normal(ray, normal);
+    rec.material = material.get();
+    rec.object = this;
+}
+
+bool Plane::occluded(const Ray& ray, float t_min, float t_max) const {
+    traversal_stats.primitive_tests++;
+    float t = crossing(ray);
+    return t >= t_min && t <= t_max;
+}
+
+BoundingBox Plane::bounding_box() const {
+    const float infinity = std::numeric_limits<float>::infinity();
+    return BoundingBox(Point3(-infinity, -infinity, -infinity), Point3(infinity, infinity, infinity));
+}
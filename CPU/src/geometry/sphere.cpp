@@ -1,12 +1,16 @@
 #include "geometry/sphere.h"
+#include "core/traversal_stats.h"
 #include "materials/material.h"
 #include "math/ray.h"
+#include "sampling/sampler.h"
+#include <algorithm>
 #include <cmath>
 
 Sphere::Sphere(const Point3& center, float radius, std::shared_ptr<Material> material)
     : center(center), radius(radius), material(material) {}
 
-bool Sphere::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const {
+bool Sphere::intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const {
+    traversal_stats.primitive_tests++;
     Vec3 oc = ray.origin - center;
     float a = ray.direction.length_squared();
     float half_b = oc.dot(ray.direction);
@@ -25,15 +29,74 @@ bool Sphere::hit(const Ray& ray, float t_min, float t_max, HitRecord& rec) const
             return false;
     }
     
-    rec.t = root;
+    isect.t = root;
+    isect.primitive = this;
+    isect.instance = nullptr;
+    return true;
+}
+
+void Sphere::surface_interaction(const Ray& ray, const Intersection& isect, HitRecord& rec) const {
+    rec.t = isect.t;
     rec.point = ray.at(rec.t);
     Vec3 outward_normal = (rec.point - center) / radius;
     rec.set_face_normal(ray, outward_normal);
     rec.material = material.get();
+    rec.object = this;
+}
+
+bool Sphere::occluded(const Ray& ray, float t_min, float t_max) const {
+    traversal_stats.primitive_tests++;
+    Vec3 oc = ray.origin - center;
+    float a = ray.direction.length_squared();
+    float half_b = oc.dot(ray.direction);
+    float c = oc.length_squared() - radius * radius;
+    
+    float discriminant = half_b * half_b - a * c;
+    if (discriminant < 0) return false;
+    
+    // Either root in range counts; no hit point or normal is needed
+    float sqrtd = sqrt(discriminant);
+    float near_root = (-half_b - sqrtd) / a;
+    float far_root = (-half_b + sqrtd) / a;
+    return (near_root >= t_min && near_root <= t_max) || (far_root >= t_min && far_root <= t_max);
+}
+
+bool Sphere::sample_solid_angle(const Point3& ref, const Sample2D& sample, Vec3& direction, float& pdf) const {
+    Vec3 to_center = center - ref;
+    float dist2 = to_center.length_squared();
+    float radius2 = radius * radius;
+    if (dist2 <= radius2) return false;
+    
+    // 1 - cos(theta_max), written to stay accurate for small, distant spheres
+    float sin2_max = radius2 / dist2;
+    float cos_max = sqrt(1.0f - sin2_max);
+    float one_minus_cos_max = sin2_max / (1.0f + cos_max);
     
+    float cos_theta = 1.0f - sample.u * one_minus_cos_max;
+    float sin_theta = sqrt(std::max(0.0f, 1.0f - cos_theta * cos_theta));
+    float phi = 2.0f * M_PI * sample.v;
+    
+    // Orthonormal basis around the axis toward the center
+    Vec3 w = to_center / sqrt(dist2);
+    Vec3 a = fabs(w.x) > 0.9f ? Vec3(0, 1, 0) : Vec3(1, 0, 0);
+    Vec3 v = w.cross(a).normalize();
+    Vec3 u = w.cross(v);
+    
+    direction = u * (cos(phi) * sin_theta) + v * (sin(phi) * sin_theta) + w * cos_theta;
+    pdf = 1.0f / (2.0f * M_PI * one_minus_cos_max);
     return true;
 }
 
+float Sphere::solid_angle_pdf(const Point3& ref) const {
+    float dist2 = (center - ref).length_squared();
+    float radius2 = radius * radius;
+    if (dist2 <= radius2) return 0.0f;
+    
+    float sin2_max = radius2 / dist2;
+    float one_minus_cos_max = sin2_max / (1.0f + sqrt(1.0f - sin2_max));
+    return 1.0f / (2.0f * M_PI * one_minus_cos_max);
+}
+
 BoundingBox Sphere::bounding_box() const {
     Vec3 radius_vec(radius, radius, radius);
     return BoundingBox(center - radius_vec, center + radius_vec);
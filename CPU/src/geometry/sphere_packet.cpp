@@ -0,0 +1,62 @@
+#include "geometry/sphere_packet.h"
+#include "geometry/sphere.h"
+#include "core/scene_arena.h"
+#include "core/traversal_stats.h"
+#include "simd/kernels.h"
+
+SpherePacket::SpherePacket()
+    : spheres(nullptr), count(0), center_x(nullptr), center_y(nullptr), center_z(nullptr), radius(nullptr) {}
+
+void SpherePacket::assign(const std::vector<const Sphere*>& source, SceneArena& arena) {
+    count = source.size();
+    if (count == 0) {
+        return;
+    }
+    
+    const Sphere** pointers = arena.allocate_array<const Sphere*>(count);
+    float* cx = arena.allocate_array<float>(count);
+    float* cy = arena.allocate_array<float>(count);
+    float* cz = arena.allocate_array<float>(count);
+    float* r = arena.allocate_array<float>(count);
+    for (size_t i = 0; i < count; i++) {
+        pointers[i] = source[i];
+        cx[i] = source[i]->center.x;
+        cy[i] = source[i]->center.y;
+        cz[i] = source[i]->center.z;
+        r[i] = source[i]->radius;
+    }
+    
+    spheres = pointers;
+    center_x = cx;
+    center_y = cy;
+    center_z = cz;
+    radius = r;
+}
+
+bool SpherePacket::intersect(const Ray& ray, float t_min, float t_max, Intersection& isect) const {
+    if (count == 0) {
+        return false;
+    }
+    traversal_stats.primitive_tests += count;
+    SphereArrays arrays = {center_x, center_y, center_z, radius};
+    float t;
+    int index = simd_kernels().ray_spheres(arrays, count, KernelRay(ray), t_min, t_max, t);
+    if (index < 0) {
+        return false;
+    }
+    
+    isect.t = t;
+    isect.primitive = spheres[index];
+    isect.instance = nullptr;
+    return true;
+}
+
+bool SpherePacket::occluded(const Ray& ray, float t_min, float t_max) const {
+    if (count == 0) {
+        return false;
+    }
+    traversal_stats.primitive_tests += count;
+    SphereArrays arrays = {center_x, center_y, center_z, radius};
+    float t;
+    return simd_kernels().ray_spheres(arrays, count, KernelRay(ray), t_min, t_max, t) >= 0;
+}
@@ -1,40 +1,242 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "rendering/incremental_renderer.h"
+#include "rendering/numa_benchmark.h"
 #include "rendering/renderer.h"
-#include "scenes/simple_scene.h"
-#include "scenes/complex_scene.h"
+#include "rendering/sampler_comparison.h"
+#include "scenes/scene_registry.h"
+#include "server/render_server.h"
+#include "simd/kernels.h"
+#include "utils/trace.h"
 
 void print_usage(const char* program_name) {
     std::cerr << "Usage: " << program_name << " [scene] [options]\n";
     std::cerr << "\nScenes:\n";
     std::cerr << "  simple  - Simple scene with 4 spheres (default)\n";
     std::cerr << "  complex - Complex scene with 500+ spheres\n";
+    std::cerr << "  instanced - 1024 instances sharing one sphere cluster\n";
+    std::cerr << "  lights  - Room lit only by small emissive spheres\n";
+    std::cerr << "  field   - 1M+ small spheres on a plane, for accelerator memory tests\n";
     std::cerr << "\nOptions:\n";
     std::cerr << "  --list     - Use linear list instead of kd-tree\n";
     std::cerr << "  --kdtree   - Use kd-tree acceleration (default)\n";
+    std::cerr << "  --kdtree-q16 - Kd-tree with child bounds quantized to 16 bits (less node memory)\n";
+    std::cerr << "  --kdtree-q8  - Kd-tree with child bounds quantized to 8 bits (least node memory)\n";
+    std::cerr << "  --grid     - Use a uniform grid with automatic resolution\n";
+    std::cerr << "  --spp <n>  - Override the scene's samples per pixel\n";
+    std::cerr << "  --width <n> - Override the scene's image width (height follows its aspect ratio)\n";
+    std::cerr << "  --stream   - Render in bands with bounded memory, writing a binary PPM as it goes\n";
+    std::cerr << "  --stream-window <n> - Bands kept in memory by --stream (default: 2 per thread)\n";
+    std::cerr << "  --denoise  - Run the feature-guided denoiser on the final image\n";
+    std::cerr << "  --sampler <name>  - independent (default), stratified, halton, sobol, bluenoise\n";
+    std::cerr << "  --compare-samplers - Equal-time RMSE of all samplers against a reference\n";
+    std::cerr << "  --reference-spp <n> - Reference sample count for --compare-samplers (default: 1024)\n";
+    std::cerr << "  --time-budget <ms> - Progressive passes until the deadline, then output\n";
+    std::cerr << "  --preview <prefix> - With --time-budget, write <prefix>_passN.ppm after each pass\n";
+    std::cerr << "  --animate <file>  - Render frames along a keyframed camera path\n";
+    std::cerr << "  --frames <a>-<b>  - Frame range to render (default: whole path)\n";
+    std::cerr << "  --output <prefix> - Animation output prefix (default: frame)\n";
+    std::cerr << "  --ao       - Render ambient occlusion using any-hit occlusion queries\n";
+    std::cerr << "  --ao-distance <d> - Maximum occluder distance for --ao (default: 1)\n";
+    std::cerr << "  --ao-closest-hit - Answer AO rays with closest-hit queries (for comparison)\n";
+    std::cerr << "  --move <i>:<dx>,<dy>,<dz> - After rendering, move sphere i and re-render only the affected\n";
+    std::cerr << "                tiles; repeat for a sequence of edits\n";
+    std::cerr << "  --influence <d> - With --move, also redo tiles whose surfaces lie within d of the sphere (default: 1)\n";
+    std::cerr << "  --check-edits - With --move, compare each update against a full render\n";
+    std::cerr << "  --heatmap <prefix> - Also write per-pixel cost heatmaps (nodes, primitives, bounces, cycles)\n";
+    std::cerr << "  --numa     - Pin threads to cores and keep image rows in the memory of the NUMA node rendering them\n";
+    std::cerr << "  --numa-replicate - Like --numa, plus a copy of the accelerator on every NUMA node\n";
+    std::cerr << "  --numa-bench - Compare one NUMA node against all of them, pinned and unpinned\n";
+    std::cerr << "  --isa <name> - SIMD kernels: baseline, sse4.2, avx2, avx512 (default: best for this CPU)\n";
+    std::cerr << "  --server   - Serve render jobs from stdin, binary results to stdout\n";
+    std::cerr << "  --server-socket <path> - Serve render jobs on a Unix domain socket\n";
+    std::cerr << "  --cache-size <n> - Built scenes kept by the server (default: 4)\n";
+    std::cerr << "  --trace <file> - Write a Chrome trace-event timeline (chrome://tracing, Perfetto)\n";
     std::cerr << "\nExamples:\n";
     std::cerr << "  " << program_name << " simple > simple.ppm\n";
     std::cerr << "  " << program_name << " complex --list > complex_slow.ppm\n";
     std::cerr << "  " << program_name << " complex --kdtree > complex_fast.ppm\n";
+    std::cerr << "  " << program_name << " complex --spp 8 --denoise > complex_denoised.ppm\n";
+    std::cerr << "  " << program_name << " complex --time-budget 500 --denoise > preview.ppm\n";
+    std::cerr << "  " << program_name << " complex --animate path.txt --frames 0-119 --output fly\n";
+    std::cerr << "  echo 'render id=1 scene=complex width=200 spp=4' | " << program_name << " --server > out.bin\n";
+}
+
+// A mode flag given on the command line, or a feature flag some modes ignore
+struct GivenFlag {
+    const char* name;
+    bool given;
+};
+
+// The first flag given that is neither mode itself nor in supported, or nullptr
+const char* unsupported_flag(const std::vector<GivenFlag>& flags, const char* mode,
+                             const std::vector<std::string>& supported) {
+    for (const GivenFlag& flag : flags) {
+        if (flag.given && mode != std::string(flag.name) &&
+            std::find(supported.begin(), supported.end(), flag.name) == supported.end()) {
+            return flag.name;
+        }
+    }
+    return nullptr;
 }
 
 int main(int argc, char* argv[]) {
     // Default settings
     std::string scene_type = "simple";
-    bool use_kdtree = true;
+    RenderOptions options;
+    std::string camera_path_file;
+    bool compare = false;
+    bool numa_bench = false;
+    int reference_spp = 1024;
+    std::string output_prefix = "frame";
+    int first_frame = 0;
+    int last_frame = 0;
+    bool frame_range_given = false;
+    bool server = false;
+    std::string server_socket;
+    int cache_size = 4;
+    std::string trace_file;
+    std::vector<ObjectMove> moves;
+    float influence_distance = 1.0f;
+    bool check_edits = false;
     
     // Parse command line arguments
     for (int i = 1; i < argc; i++) {
         std::string arg = argv[i];
         
-        if (arg == "simple" || arg == "complex") {
+        if (arg.compare(0, 2, "--") != 0 && arg != "-h") {
             scene_type = arg;
         } else if (arg == "--list") {
-            use_kdtree = false;
+            options.accelerator = AcceleratorType::List;
         } else if (arg == "--kdtree") {
-            use_kdtree = true;
+            options.accelerator = AcceleratorType::KDTree;
+        } else if (arg == "--kdtree-q16") {
+            options.accelerator = AcceleratorType::KDTreeQuantized16;
+        } else if (arg == "--kdtree-q8") {
+            options.accelerator = AcceleratorType::KDTreeQuantized8;
+        } else if (arg == "--grid") {
+            options.accelerator = AcceleratorType::Grid;
+        } else if (arg == "--spp" && i + 1 < argc) {
+            options.samples_per_pixel = std::atoi(argv[++i]);
+            if (options.samples_per_pixel <= 0) {
+                std::cerr << "Invalid sample count: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--width" && i + 1 < argc) {
+            options.image_width = std::atoi(argv[++i]);
+            if (options.image_width < 2) {
+                std::cerr << "Invalid width: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--stream") {
+            options.stream = true;
+        } else if (arg == "--stream-window" && i + 1 < argc) {
+            options.stream_window = std::atoi(argv[++i]);
+            if (options.stream_window <= 0) {
+                std::cerr << "Invalid stream window: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--denoise") {
+            options.denoise = true;
+        } else if (arg == "--sampler" && i + 1 < argc) {
+            if (!parse_sampler_type(argv[++i], options.sampler)) {
+                std::cerr << "Unknown sampler: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--compare-samplers") {
+            compare = true;
+        } else if (arg == "--reference-spp" && i + 1 < argc) {
+            reference_spp = std::atoi(argv[++i]);
+            if (reference_spp <= 0) {
+                std::cerr << "Invalid sample count: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--time-budget" && i + 1 < argc) {
+            options.time_budget_ms = std::atoi(argv[++i]);
+            if (options.time_budget_ms <= 0) {
+                std::cerr << "Invalid time budget: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--preview" && i + 1 < argc) {
+            options.preview_prefix = argv[++i];
+        } else if (arg == "--animate" && i + 1 < argc) {
+            camera_path_file = argv[++i];
+        } else if (arg == "--frames" && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d-%d", &first_frame, &last_frame) != 2 || first_frame > last_frame) {
+                std::cerr << "Invalid frame range: " << argv[i] << "\n";
+                return 1;
+            }
+            frame_range_given = true;
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_prefix = argv[++i];
+        } else if (arg == "--ao") {
+            options.ambient_occlusion = true;
+        } else if (arg == "--ao-distance" && i + 1 < argc) {
+            options.ao_distance = std::atof(argv[++i]);
+            if (options.ao_distance <= 0.0f) {
+                std::cerr << "Invalid AO distance: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--ao-closest-hit") {
+            options.ambient_occlusion = true;
+            options.ao_closest_hit = true;
+        } else if (arg == "--move" && i + 1 < argc) {
+            unsigned long object;
+            ObjectMove move;
+            if (sscanf(argv[++i], "%lu:%f,%f,%f", &object, &move.offset.x, &move.offset.y, &move.offset.z) != 4) {
+                std::cerr << "Invalid move: " << argv[i] << "\n";
+                return 1;
+            }
+            move.object = object;
+            moves.push_back(move);
+        } else if (arg == "--influence" && i + 1 < argc) {
+            influence_distance = std::atof(argv[++i]);
+            if (influence_distance < 0.0f) {
+                std::cerr << "Invalid influence distance: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--check-edits") {
+            check_edits = true;
+        } else if (arg == "--heatmap" && i + 1 < argc) {
+            options.heatmap_prefix = argv[++i];
+        } else if (arg == "--numa") {
+            options.numa = true;
+        } else if (arg == "--numa-replicate") {
+            options.numa = true;
+            options.numa_replicate = true;
+        } else if (arg == "--numa-bench") {
+            numa_bench = true;
+        } else if (arg == "--isa" && i + 1 < argc) {
+            Isa isa;
+            if (!parse_isa(argv[++i], isa)) {
+                std::cerr << "Unknown ISA: " << argv[i] << "\n";
+                return 1;
+            }
+            try {
+                select_isa(isa);
+            } catch (const std::exception& e) {
+                std::cerr << e.what() << "\n";
+                return 1;
+            }
+        } else if (arg == "--server") {
+            server = true;
+        } else if (arg == "--server-socket" && i + 1 < argc) {
+            server = true;
+            server_socket = argv[++i];
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            cache_size = std::atoi(argv[++i]);
+            if (cache_size <= 0) {
+                std::cerr << "Invalid cache size: " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--trace" && i + 1 < argc) {
+            trace_file = argv[++i];
         } else if (arg == "--help" || arg == "-h") {
             print_usage(argv[0]);
             return 0;
@@ -45,21 +247,126 @@ int main(int argc, char* argv[]) {
         }
     }
     
+    if (!options.preview_prefix.empty() && options.time_budget_ms <= 0) {
+        std::cerr << "--preview requires --time-budget\n";
+        return 1;
+    }
+    
+    // The first mode flag picks the mode, in the same order as the dispatch
+    // below. Feature flags the mode would ignore are refused.
+    const std::vector<GivenFlag> flags = {
+        {"--server", server},
+        {"--compare-samplers", compare},
+        {"--numa-bench", numa_bench},
+        {"--animate", !camera_path_file.empty()},
+        {"--move", !moves.empty()},
+        {"--stream", options.stream},
+        {"--time-budget", options.time_budget_ms > 0},
+        {"--denoise", options.denoise},
+        {"--heatmap", !options.heatmap_prefix.empty()},
+        {"--numa", options.numa && !options.numa_replicate},
+        {"--numa-replicate", options.numa_replicate},
+    };
+    const char* mode = nullptr;
+    std::vector<std::string> supported = {"--denoise", "--heatmap", "--numa", "--numa-replicate"};
+    if (server) {
+        mode = "--server";
+        supported = {"--numa", "--numa-replicate"};
+    } else if (compare) {
+        mode = "--compare-samplers";
+        supported = {"--numa", "--numa-replicate"};
+    } else if (numa_bench) {
+        mode = "--numa-bench";
+        supported = {};
+    } else if (!camera_path_file.empty()) {
+        mode = "--animate";
+        supported = {"--denoise", "--numa", "--numa-replicate"};
+    } else if (!moves.empty()) {
+        mode = "--move";
+        supported = {"--numa", "--numa-replicate"};
+    } else if (options.stream) {
+        mode = "--stream";
+        supported = {"--numa", "--numa-replicate"};
+    } else if (options.time_budget_ms > 0) {
+        mode = "--time-budget";
+        supported = {"--denoise", "--numa", "--numa-replicate"};
+    }
+    if (mode) {
+        if (const char* flag = unsupported_flag(flags, mode, supported)) {
+            std::cerr << flag << " cannot be combined with " << mode << "\n";
+            return 1;
+        }
+    }
+    
+    if (!trace_file.empty()) {
+        Tracer::start();
+        Tracer::set_thread_name("main");
+    }
+    
+    // Server mode picks scenes per job
+    if (server) {
+        try {
+            RenderServer render_server(options, cache_size);
+            if (server_socket.empty()) {
+                render_server.serve_stdio();
+            } else {
+                render_server.serve_socket(server_socket);
+            }
+            if (!trace_file.empty()) {
+                Tracer::write(trace_file);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "Server error: " << e.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+    
     // Create the appropriate scene
-    std::unique_ptr<Scene> scene;
-    if (scene_type == "simple") {
-        scene = std::make_unique<SimpleScene>();
-    } else if (scene_type == "complex") {
-        scene = std::make_unique<ComplexScene>();
-    } else {
+    std::unique_ptr<Scene> scene = create_scene(scene_type);
+    if (!scene) {
         std::cerr << "Unknown scene type: " << scene_type << "\n";
         print_usage(argv[0]);
         return 1;
     }
     
+    // The width alone cannot rule out a degenerate image; the height follows
+    // from the scene's aspect ratio
+    SceneConfig config = scene->get_config();
+    options.apply(config);
+    if (config.get_image_height() < 2) {
+        std::cerr << "Width " << config.image_width << " gives a " << config.image_width << "x"
+                  << config.get_image_height() << " image for this scene; at least 2x2 is needed\n";
+        return 1;
+    }
+    
     // Render the scene
     try {
-        Renderer::render_scene(std::move(scene), use_kdtree);
+        if (compare) {
+            compare_samplers(*scene, options, reference_spp);
+        } else if (numa_bench) {
+            numa_scaling_benchmark(*scene, options);
+        } else if (!camera_path_file.empty()) {
+            CameraPath path = CameraPath::load(camera_path_file);
+            if (!frame_range_given) {
+                first_frame = path.first_frame();
+                last_frame = path.last_frame();
+            }
+            Renderer::render_animation(std::move(scene), options, path,
+                                       first_frame, last_frame, output_prefix);
+        } else if (!moves.empty()) {
+            render_edits(std::move(scene), options, moves, influence_distance, check_edits);
+        } else if (options.stream) {
+            Renderer::render_streaming(std::move(scene), options);
+        } else if (options.time_budget_ms > 0) {
+            Renderer::render_progressive(std::move(scene), options);
+        } else {
+            Renderer::render_scene(std::move(scene), options);
+        }
+        if (!trace_file.empty()) {
+            Tracer::write(trace_file);
+            std::cerr << "Trace written to " << trace_file << "\n";
+        }
     } catch (const std::exception& e) {
         std::cerr << "Error during rendering: " << e.what() << "\n";
         return 1;
@@ -0,0 +1,29 @@
+#include "materials/diffuse_light.h"
+#include "core/hit_record.h"
+
+DiffuseLight::DiffuseLight(const Color& emit) : emit(emit) {}
+
+bool DiffuseLight::scatter(const Ray&, const HitRecord&, Sampler&, Color&, Ray&) const {
+    return false;
+}
+
+Color DiffuseLight::eval(const HitRecord&, const Vec3&) const {
+    return Color(0, 0, 0);
+}
+
+float DiffuseLight::pdf(const HitRecord&, const Vec3&) const {
+    return 0.0f;
+}
+
+Color DiffuseLight::emitted(const HitRecord& rec) const {
+    return rec.front_face ? emit : Color(0, 0, 0);
+}
+
+bool DiffuseLight::is_emissive() const {
+    return true;
+}
+
+Color DiffuseLight::base_color() const {
+    // Lights demodulate to their own radiance
+    return emit;
+}
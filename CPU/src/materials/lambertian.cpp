@@ -1,13 +1,13 @@
 #include "materials/lambertian.h"
 #include "core/hit_record.h"
 #include "math/ray.h"
-#include <random>
+#include "sampling/sampler.h"
 #include <cmath>
 
 Lambertian::Lambertian(const Color& albedo) : albedo(albedo) {}
 
-bool Lambertian::scatter(const Ray& ray_in, const HitRecord& rec, Color& attenuation, Ray& scattered) const {
-    Vec3 scatter_direction = rec.normal + random_unit_vector();
+bool Lambertian::scatter(const Ray&, const HitRecord& rec, Sampler& sampler, Color& attenuation, Ray& scattered) const {
+    Vec3 scatter_direction = rec.normal + random_unit_vector(sampler);
     
     // Catch degenerate scatter direction
     if (near_zero(scatter_direction)) {
@@ -19,13 +19,26 @@ bool Lambertian::scatter(const Ray& ray_in, const HitRecord& rec, Color& attenua
     return true;
 }
 
-Vec3 Lambertian::random_unit_vector() const {
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+Color Lambertian::eval(const HitRecord& rec, const Vec3& direction) const {
+    float cosine = rec.normal.dot(direction.normalize());
+    return cosine > 0.0f ? albedo * (cosine / M_PI) : Color(0, 0, 0);
+}
+
+float Lambertian::pdf(const HitRecord& rec, const Vec3& direction) const {
+    // normal + uniform unit vector is cosine distributed
+    float cosine = rec.normal.dot(direction.normalize());
+    return cosine > 0.0f ? cosine / M_PI : 0.0f;
+}
+
+Color Lambertian::base_color() const {
+    return albedo;
+}
+
+Vec3 Lambertian::random_unit_vector(Sampler& sampler) const {
+    Sample2D sample = sampler.get_2d();
     
-    float a = dis(gen) * 2.0f * M_PI;
-    float z = dis(gen) * 2.0f - 1.0f;
+    float a = sample.u * 2.0f * M_PI;
+    float z = sample.v * 2.0f - 1.0f;
     float r = sqrt(1.0f - z * z);
     return Vec3(r * cos(a), r * sin(a), z);
 }
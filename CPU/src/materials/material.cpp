@@ -0,0 +1,5 @@
+#include "materials/material.h"
+
+Color Material::emitted(const HitRecord&) const {
+    return Color(0, 0, 0);
+}
@@ -0,0 +1,108 @@
+#include "math/transform.h"
+#include "math/ray.h"
+#include <cmath>
+
+Transform::Transform() {
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 4; c++) {
+            m[r][c] = (r == c) ? 1.0f : 0.0f;
+        }
+    }
+}
+
+Transform Transform::translate(const Vec3& offset) {
+    Transform t;
+    t.m[0][3] = offset.x;
+    t.m[1][3] = offset.y;
+    t.m[2][3] = offset.z;
+    return t;
+}
+
+Transform Transform::scale(float s) {
+    Transform t;
+    t.m[0][0] = s;
+    t.m[1][1] = s;
+    t.m[2][2] = s;
+    return t;
+}
+
+Transform Transform::rotate_y(float degrees) {
+    float radians = degrees * M_PI / 180.0f;
+    float cos_theta = cos(radians);
+    float sin_theta = sin(radians);
+    
+    Transform t;
+    t.m[0][0] = cos_theta;  t.m[0][2] = sin_theta;
+    t.m[2][0] = -sin_theta; t.m[2][2] = cos_theta;
+    return t;
+}
+
+Transform Transform::operator*(const Transform& other) const {
+    Transform result;
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 4; c++) {
+            float sum = (c == 3) ? m[r][3] : 0.0f;
+            for (int k = 0; k < 3; k++) {
+                sum += m[r][k] * other.m[k][c];
+            }
+            result.m[r][c] = sum;
+        }
+    }
+    return result;
+}
+
+Transform Transform::inverse() const {
+    // Invert the 3x3 linear part via the adjugate, then the translation
+    float a = m[0][0], b = m[0][1], c = m[0][2];
+    float d = m[1][0], e = m[1][1], f = m[1][2];
+    float g = m[2][0], h = m[2][1], i = m[2][2];
+    
+    float det = a * (e * i - f * h) - b * (d * i - f * g) + c * (d * h - e * g);
+    float inv_det = 1.0f / det;
+    
+    Transform inv;
+    inv.m[0][0] = (e * i - f * h) * inv_det;
+    inv.m[0][1] = (c * h - b * i) * inv_det;
+    inv.m[0][2] = (b * f - c * e) * inv_det;
+    inv.m[1][0] = (f * g - d * i) * inv_det;
+    inv.m[1][1] = (a * i - c * g) * inv_det;
+    inv.m[1][2] = (c * d - a * f) * inv_det;
+    inv.m[2][0] = (d * h - e * g) * inv_det;
+    inv.m[2][1] = (b * g - a * h) * inv_det;
+    inv.m[2][2] = (a * e - b * d) * inv_det;
+    
+    Vec3 t = inv.transform_vector(Vec3(m[0][3], m[1][3], m[2][3]));
+    inv.m[0][3] = -t.x;
+    inv.m[1][3] = -t.y;
+    inv.m[2][3] = -t.z;
+    return inv;
+}
+
+Point3 Transform::transform_point(const Point3& p) const {
+    return Point3(
+        m[0][0] * p.x + m[0][1] * p.y + m[0][2] * p.z + m[0][3],
+        m[1][0] * p.x + m[1][1] * p.y + m[1][2] * p.z + m[1][3],
+        m[2][0] * p.x + m[2][1] * p.y + m[2][2] * p.z + m[2][3]
+    );
+}
+
+Vec3 Transform::transform_vector(const Vec3& v) const {
+    return Vec3(
+        m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z,
+        m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z,
+        m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z
+    );
+}
+
+Vec3 Transform::transform_normal(const Vec3& n) const {
+    // Multiply by the transpose of the linear part
+    return Vec3(
+        m[0][0] * n.x + m[1][0] * n.y + m[2][0] * n.z,
+        m[0][1] * n.x + m[1][1] * n.y + m[2][1] * n.z,
+        m[0][2] * n.x + m[1][2] * n.y + m[2][2] * n.z
+    );
+}
+
+Ray Transform::transform_ray(const Ray& ray) const {
+    return Ray(transform_point(ray.origin), transform_vector(ray.direction));
+}
@@ -0,0 +1,79 @@
+#include "rendering/camera_path.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+Vec3 catmull_rom(const Vec3& p0, const Vec3& p1, const Vec3& p2, const Vec3& p3, float t) {
+    float t2 = t * t;
+    float t3 = t2 * t;
+    return (p1 * 2.0f
+          + (p2 - p0) * t
+          + (p0 * 2.0f - p1 * 5.0f + p2 * 4.0f - p3) * t2
+          + (p1 * 3.0f - p0 - p2 * 3.0f + p3) * t3) * 0.5f;
+}
+
+}
+
+CameraPath CameraPath::load(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in) {
+        throw std::runtime_error("Cannot open camera path: " + filename);
+    }
+    
+    CameraPath path;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        if (line.empty() || line[0] == '#') continue;
+        
+        std::istringstream fields(line);
+        CameraKeyframe key;
+        if (!(fields >> key.frame
+                     >> key.position.x >> key.position.y >> key.position.z
+                     >> key.target.x >> key.target.y >> key.target.z
+                     >> key.fov)) {
+            throw std::runtime_error(filename + ":" + std::to_string(line_number) + ": malformed keyframe");
+        }
+        path.keyframes.push_back(key);
+    }
+    
+    if (path.keyframes.empty()) {
+        throw std::runtime_error("Camera path has no keyframes: " + filename);
+    }
+    
+    std::sort(path.keyframes.begin(), path.keyframes.end(),
+              [](const CameraKeyframe& a, const CameraKeyframe& b) { return a.frame < b.frame; });
+    return path;
+}
+
+int CameraPath::first_frame() const {
+    return static_cast<int>(keyframes.front().frame);
+}
+
+int CameraPath::last_frame() const {
+    return static_cast<int>(keyframes.back().frame);
+}
+
+void CameraPath::apply(float frame, SceneConfig& config) const {
+    // Find the segment [i, i+1] containing frame, clamping outside the path
+    size_t i = 0;
+    while (i + 2 < keyframes.size() && keyframes[i + 1].frame <= frame) {
+        i++;
+    }
+    
+    const CameraKeyframe& k1 = keyframes[i];
+    const CameraKeyframe& k2 = keyframes[std::min(i + 1, keyframes.size() - 1)];
+    const CameraKeyframe& k0 = keyframes[i > 0 ? i - 1 : i];
+    const CameraKeyframe& k3 = keyframes[std::min(i + 2, keyframes.size() - 1)];
+    
+    float span = k2.frame - k1.frame;
+    float t = span > 0.0f ? std::clamp((frame - k1.frame) / span, 0.0f, 1.0f) : 0.0f;
+    
+    config.camera_pos = catmull_rom(k0.position, k1.position, k2.position, k3.position, t);
+    config.camera_target = catmull_rom(k0.target, k1.target, k2.target, k3.target, t);
+    config.camera_fov = k1.fov + (k2.fov - k1.fov) * t;
+}
@@ -0,0 +1,104 @@
+#include "rendering/cost_map.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+const int METRIC_COUNT = 4;
+const char* const METRIC_NAMES[METRIC_COUNT] = {"nodes", "primitives", "bounces", "cycles"};
+
+float metric(const PixelCost& cost, int m) {
+    switch (m) {
+        case 0: return cost.nodes;
+        case 1: return cost.primitives;
+        case 2: return cost.bounces;
+        default: return cost.cycles;
+    }
+}
+
+// Piecewise-linear ramp through blue, cyan, green, yellow and red
+Color heat_color(float value) {
+    static const Color stops[] = {
+        Color(0.0f, 0.0f, 0.5f), Color(0.0f, 0.8f, 1.0f), Color(0.1f, 0.9f, 0.1f),
+        Color(1.0f, 0.9f, 0.0f), Color(0.9f, 0.0f, 0.0f)
+    };
+    const int segments = sizeof(stops) / sizeof(stops[0]) - 1;
+    
+    float x = std::min(std::max(value, 0.0f), 1.0f) * segments;
+    int i = std::min(static_cast<int>(x), segments - 1);
+    float f = x - i;
+    return stops[i] * (1.0f - f) + stops[i + 1] * f;
+}
+
+void write_heatmap(const std::string& filename, const std::vector<float>& values,
+                   int width, int height, float scale_max) {
+    std::ofstream out(filename);
+    if (!out) {
+        throw std::runtime_error("Cannot open output file: " + filename);
+    }
+    
+    float inv_max = scale_max > 0.0f ? 1.0f / scale_max : 0.0f;
+    out << "P3\n" << width << ' ' << height << "\n255\n";
+    for (float value : values) {
+        Color c = heat_color(value * inv_max);
+        out << static_cast<int>(255.999f * c.x) << ' '
+            << static_cast<int>(255.999f * c.y) << ' '
+            << static_cast<int>(255.999f * c.z) << '\n';
+    }
+}
+
+}
+
+void write_cost_maps(const std::string& prefix, const Framebuffer& framebuffer, int samples_per_pixel) {
+    if (!framebuffer.has_cost_map()) {
+        throw std::runtime_error("Framebuffer has no cost map");
+    }
+    
+    size_t pixel_count = framebuffer.cost.size();
+    float scale = 1.0f / samples_per_pixel;
+    
+    std::vector<float> values(pixel_count);
+    for (int m = 0; m < METRIC_COUNT; m++) {
+        double total = 0.0;
+        for (size_t i = 0; i < pixel_count; i++) {
+            values[i] = metric(framebuffer.cost[i], m) * scale;
+            total += values[i];
+        }
+        
+        std::vector<float> sorted = values;
+        size_t p99 = std::min(pixel_count - 1, pixel_count * 99 / 100);
+        std::nth_element(sorted.begin(), sorted.begin() + p99, sorted.end());
+        float percentile = sorted[p99];
+        float max_value = *std::max_element(sorted.begin() + p99, sorted.end());
+        
+        std::string filename = prefix + "_" + METRIC_NAMES[m] + ".ppm";
+        write_heatmap(filename, values, framebuffer.width, framebuffer.height, percentile);
+        std::cerr << "Cost " << METRIC_NAMES[m] << " per sample: mean " << total / pixel_count
+                  << ", p99 " << percentile << " (red), max " << max_value << " -> " << filename << "\n";
+    }
+    
+    std::string raw_name = prefix + "_cost.raw";
+    std::ofstream raw(raw_name, std::ios::binary);
+    if (!raw) {
+        throw std::runtime_error("Cannot open output file: " + raw_name);
+    }
+    raw << "cost " << framebuffer.width << ' ' << framebuffer.height << ' ' << METRIC_COUNT << '\n';
+    
+    std::vector<float> record(METRIC_COUNT * static_cast<size_t>(framebuffer.width));
+    for (int y = 0; y < framebuffer.height; y++) {
+        for (int x = 0; x < framebuffer.width; x++) {
+            const PixelCost& cost = framebuffer.cost[framebuffer.index(x, y)];
+            for (int m = 0; m < METRIC_COUNT; m++) {
+                record[METRIC_COUNT * x + m] = metric(cost, m) * scale;
+            }
+        }
+        raw.write(reinterpret_cast<const char*>(record.data()), record.size() * sizeof(float));
+    }
+    if (!raw) {
+        throw std::runtime_error("Failed writing " + raw_name);
+    }
+    std::cerr << "Raw cost buffer -> " << raw_name << "\n";
+}
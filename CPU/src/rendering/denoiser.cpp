@@ -0,0 +1,152 @@
+#include "rendering/denoiser.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Planar copies of a three-channel buffer, so the filter's inner loops
+// run over contiguous floats and auto-vectorize
+struct Planes {
+    std::vector<float> x, y, z;
+    
+    explicit Planes(size_t n) : x(n), y(n), z(n) {}
+};
+
+// exp(-v) approximation for v >= 0. Positive and monotonic, which is all a
+// filter weight needs, and unlike expf it vectorizes without -ffast-math.
+inline float fast_exp_neg(float v) {
+    return 1.0f / (1.0f + v * (1.0f + v * (0.5f + v * (1.0f / 6.0f))));
+}
+
+const float MIN_ALBEDO = 1e-3f;
+
+}
+
+void Denoiser::denoise(
+    Framebuffer& framebuffer,
+    int samples_per_pixel,
+    ThreadPool& pool,
+    const DenoiseSettings& settings) {
+    
+    if (!framebuffer.has_aovs()) return;
+    
+    const int width = framebuffer.width;
+    const int height = framebuffer.height;
+    const size_t n = framebuffer.pixels.size();
+    const float inv_spp = 1.0f / samples_per_pixel;
+    
+    Planes irradiance(n), filtered(n), albedo(n), normal(n);
+    std::vector<float> depth(n);
+    
+    // Average the sums and divide lighting by albedo
+    for (size_t i = 0; i < n; i++) {
+        Color a = framebuffer.albedo[i] * inv_spp;
+        albedo.x[i] = std::max(a.x, MIN_ALBEDO);
+        albedo.y[i] = std::max(a.y, MIN_ALBEDO);
+        albedo.z[i] = std::max(a.z, MIN_ALBEDO);
+        
+        Color c = framebuffer.pixels[i] * inv_spp;
+        irradiance.x[i] = c.x / albedo.x[i];
+        irradiance.y[i] = c.y / albedo.y[i];
+        irradiance.z[i] = c.z / albedo.z[i];
+        
+        Vec3 nrm = framebuffer.normal[i].normalize();
+        normal.x[i] = nrm.x;
+        normal.y[i] = nrm.y;
+        normal.z[i] = nrm.z;
+        
+        depth[i] = framebuffer.depth[i] * inv_spp;
+    }
+    
+    const float kernel[5] = {1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f};
+    const float inv_sigma_albedo2 = 1.0f / (settings.sigma_albedo * settings.sigma_albedo);
+    
+    for (int iteration = 0; iteration < settings.iterations; iteration++) {
+        const int step = 1 << iteration;
+        // Tighten the color tolerance as the footprint grows
+        const float inv_sigma_color2 = step / (settings.sigma_color * settings.sigma_color);
+        const float depth_scale = settings.sigma_depth * step;
+        
+        pool.parallel_for(height, [&](int y) {
+            thread_local std::vector<float> sum_r, sum_g, sum_b, sum_w;
+            sum_r.assign(width, 0.0f);
+            sum_g.assign(width, 0.0f);
+            sum_b.assign(width, 0.0f);
+            sum_w.assign(width, 0.0f);
+            
+            const size_t row = static_cast<size_t>(y) * width;
+            
+            for (int ky = 0; ky < 5; ky++) {
+                int yy = y + (ky - 2) * step;
+                if (yy < 0 || yy >= height) continue;
+                const size_t tap_row = static_cast<size_t>(yy) * width;
+                
+                for (int kx = 0; kx < 5; kx++) {
+                    const int offset = (kx - 2) * step;
+                    const int x_begin = std::max(0, -offset);
+                    const int x_end = std::min(width, width - offset);
+                    const float kernel_weight = kernel[ky] * kernel[kx];
+                    
+                    for (int x = x_begin; x < x_end; x++) {
+                        const size_t p = row + x;
+                        const size_t q = tap_row + x + offset;
+                        
+                        float dr = irradiance.x[p] - irradiance.x[q];
+                        float dg = irradiance.y[p] - irradiance.y[q];
+                        float db = irradiance.z[p] - irradiance.z[q];
+                        float color_dist2 = dr * dr + dg * dg + db * db;
+                        
+                        float ar = albedo.x[p] - albedo.x[q];
+                        float ag = albedo.y[p] - albedo.y[q];
+                        float ab = albedo.z[p] - albedo.z[q];
+                        float albedo_dist2 = ar * ar + ag * ag + ab * ab;
+                        
+                        float depth_dist = std::fabs(depth[p] - depth[q]) / (depth_scale * depth[p] + 1e-4f);
+                        
+                        float n_dot = normal.x[p] * normal.x[q] + normal.y[p] * normal.y[q] + normal.z[p] * normal.z[q];
+                        float normal_weight = std::max(n_dot, 0.0f);
+                        for (int k = 0; k < 7; k++) {  // ^128
+                            normal_weight *= normal_weight;
+                        }
+                        
+                        float weight = kernel_weight * normal_weight * fast_exp_neg(
+                            color_dist2 * inv_sigma_color2 + albedo_dist2 * inv_sigma_albedo2 + depth_dist);
+                        
+                        sum_r[x] += weight * irradiance.x[q];
+                        sum_g[x] += weight * irradiance.y[q];
+                        sum_b[x] += weight * irradiance.z[q];
+                        sum_w[x] += weight;
+                    }
+                }
+            }
+            
+            for (int x = 0; x < width; x++) {
+                const size_t p = row + x;
+                // Pixels with degenerate guides (e.g. cancelled normals) keep their value
+                if (sum_w[x] > 1e-8f) {
+                    float inv_w = 1.0f / sum_w[x];
+                    filtered.x[p] = sum_r[x] * inv_w;
+                    filtered.y[p] = sum_g[x] * inv_w;
+                    filtered.z[p] = sum_b[x] * inv_w;
+                } else {
+                    filtered.x[p] = irradiance.x[p];
+                    filtered.y[p] = irradiance.y[p];
+                    filtered.z[p] = irradiance.z[p];
+                }
+            }
+        });
+        
+        std::swap(irradiance, filtered);
+    }
+    
+    // Remodulate and restore the sample-sum convention
+    for (size_t i = 0; i < n; i++) {
+        framebuffer.pixels[i] = Color(
+            irradiance.x[i] * albedo.x[i],
+            irradiance.y[i] * albedo.y[i],
+            irradiance.z[i] * albedo.z[i]
+        ) * static_cast<float>(samples_per_pixel);
+    }
+}
@@ -0,0 +1,52 @@
+#include "rendering/framebuffer.h"
+#include "simd/kernels.h"
+#include <vector>
+
+Framebuffer::Framebuffer(int width, int height)
+    : Framebuffer(width, height, 0, 0, width, height) {}
+
+Framebuffer::Framebuffer(int width, int height, int first_column, int first_row, int image_width, int image_height)
+    : width(width), height(height), first_column(first_column), first_row(first_row),
+      image_width(image_width), image_height(image_height),
+      pixels(static_cast<size_t>(width) * height) {}
+
+void Framebuffer::enable_aovs() {
+    albedo.assign(pixels.size(), Color(0, 0, 0));
+    normal.assign(pixels.size(), Vec3(0, 0, 0));
+    depth.assign(pixels.size(), 0.0f);
+}
+
+void Framebuffer::enable_cost_map() {
+    cost.assign(pixels.size(), PixelCost{0.0f, 0.0f, 0.0f, 0.0f});
+}
+
+void write_ppm(std::ostream& out, const Framebuffer& framebuffer, int samples_per_pixel) {
+    out << "P3\n" << framebuffer.width << ' ' << framebuffer.height << "\n255\n";
+    
+    // Tone map a row at a time with the SIMD kernel, then format it
+    const SimdKernels& kernels = simd_kernels();
+    float scale = 1.0f / samples_per_pixel;
+    size_t row_values = 3 * static_cast<size_t>(framebuffer.width);
+    std::vector<uint8_t> rgb(row_values);
+    
+    for (int y = framebuffer.first_row; y < framebuffer.first_row + framebuffer.height; y++) {
+        kernels.tonemap_rgb8(&framebuffer.pixels[framebuffer.index(framebuffer.first_column, y)].x, row_values, scale, rgb.data());
+        for (size_t i = 0; i < row_values; i += 3) {
+            out << static_cast<int>(rgb[i]) << ' '
+                << static_cast<int>(rgb[i + 1]) << ' '
+                << static_cast<int>(rgb[i + 2]) << '\n';
+        }
+    }
+}
+
+void write_rgb8_rows(std::ostream& out, const Framebuffer& framebuffer, int samples_per_pixel) {
+    const SimdKernels& kernels = simd_kernels();
+    float scale = 1.0f / samples_per_pixel;
+    size_t row_values = 3 * static_cast<size_t>(framebuffer.width);
+    std::vector<uint8_t> rgb(row_values);
+    
+    for (int y = framebuffer.first_row; y < framebuffer.first_row + framebuffer.height; y++) {
+        kernels.tonemap_rgb8(&framebuffer.pixels[framebuffer.index(framebuffer.first_column, y)].x, row_values, scale, rgb.data());
+        out.write(reinterpret_cast<const char*>(rgb.data()), row_values);
+    }
+}
@@ -0,0 +1,216 @@
+#include "rendering/incremental_renderer.h"
+#include "geometry/sphere.h"
+#include "utils/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+SceneConfig configured(Scene& scene, const RenderOptions& options) {
+    SceneConfig config = scene.get_config();
+    options.apply(config);
+    return config;
+}
+
+BoundingBox expand(const BoundingBox& box, float distance) {
+    Vec3 margin(distance, distance, distance);
+    return BoundingBox(box.min - margin, box.max + margin);
+}
+
+// False for a pixel box left inside out because every sample missed
+bool overlaps(const BoundingBox& a, const BoundingBox& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+}
+
+IncrementalRenderer::IncrementalRenderer(Scene& scene, const RenderOptions& options, float influence_distance)
+    : config(configured(scene, options)),
+      options(options),
+      influence_distance(influence_distance),
+      pool(0, options.thread_placement()),
+      world(Renderer::build_world(scene, options.accelerator)),
+      camera(config.camera_pos, config.camera_target, config.camera_up, config.camera_fov, config.aspect_ratio),
+      framebuffer(config.image_width, config.get_image_height()),
+      tiles(Renderer::make_tiles(framebuffer.width, framebuffer.height)),
+      first_hits(tiles.size()) {
+    if (options.numa_replicate) {
+        Renderer::replicate_accelerator(world, options.accelerator, pool);
+    }
+}
+
+void IncrementalRenderer::render_all() {
+    std::vector<int> all(tiles.size());
+    for (size_t i = 0; i < all.size(); i++) {
+        all[i] = static_cast<int>(i);
+    }
+    render_tiles(all);
+}
+
+int IncrementalRenderer::apply(const ObjectMove& move) {
+    Sphere* sphere = nullptr;
+    if (move.object < world.objects.size()) {
+        sphere = dynamic_cast<Sphere*>(world.objects[move.object].get());
+    }
+    if (!sphere) {
+        throw std::runtime_error("Object " + std::to_string(move.object) + " is not a top-level sphere");
+    }
+    
+    BoundingBox old_bounds = sphere->bounding_box();
+    sphere->center = sphere->center + move.offset;
+    BoundingBox new_bounds = sphere->bounding_box();
+    
+    {
+        // Nodes get memory of their own, released with the tree on the next
+        // edit, instead of piling up in the scene arena
+        TraceScope trace("build accelerator");
+        world.accelerator = Renderer::build_accelerator(world.objects, options.accelerator, nullptr);
+    }
+    if (options.numa_replicate) {
+        // The per-node copies still hold the old positions
+        Renderer::replicate_accelerator(world, options.accelerator, pool);
+    }
+    
+    const Hittable* edited = sphere;
+    bool emitter = world.lights.contains(edited);
+    BoundingBox old_reach = expand(old_bounds, influence_distance);
+    BoundingBox new_reach = expand(new_bounds, influence_distance);
+    
+    std::vector<int> affected;
+    for (size_t t = 0; t < tiles.size(); t++) {
+        const TileFirstHits& hits = first_hits[t];
+        bool redo = std::binary_search(hits.objects.begin(), hits.objects.end(), edited) ||
+                    frustum_reaches(tiles[t], new_bounds);
+        for (size_t p = 0; p < hits.pixel_bounds.size() && !redo; p++) {
+            const BoundingBox& bounds = hits.pixel_bounds[p];
+            bool hit_something = bounds.min.x <= bounds.max.x;
+            redo = (emitter && hit_something) || overlaps(bounds, old_reach) || overlaps(bounds, new_reach);
+        }
+        if (redo) {
+            affected.push_back(static_cast<int>(t));
+        }
+    }
+    
+    render_tiles(affected);
+    return static_cast<int>(affected.size());
+}
+
+Framebuffer IncrementalRenderer::render_reference() {
+    Framebuffer reference(framebuffer.width, framebuffer.height);
+    Renderer::render_frame(world, camera, config, options, pool, reference);
+    return reference;
+}
+
+void IncrementalRenderer::render_tiles(const std::vector<int>& indices) {
+    TraceScope trace("render tiles");
+    pool.parallel_for(static_cast<int>(indices.size()), [&](int k) {
+        int index = indices[k];
+        const Tile& tile = tiles[index];
+        for (int y = tile.y0; y < tile.y1; y++) {
+            for (int x = tile.x0; x < tile.x1; x++) {
+                framebuffer.at(x, y) = Color(0, 0, 0);
+            }
+        }
+        Renderer::render_tile(world, camera, config, options, framebuffer, tile,
+                              0, config.samples_per_pixel, &first_hits[index]);
+    });
+}
+
+bool IncrementalRenderer::frustum_reaches(const Tile& tile, const BoundingBox& box) const {
+    // Samples land at u = (i + jitter) / (width - 1) for jitter in [0, 1), and
+    // likewise for v with rows counted from the bottom; half a pixel of margin
+    // on each side absorbs rounding
+    float u_scale = 1.0f / (framebuffer.image_width - 1);
+    float v_scale = 1.0f / (framebuffer.image_height - 1);
+    float u0 = (tile.x0 - 0.5f) * u_scale;
+    float u1 = (tile.x1 + 0.5f) * u_scale;
+    float v0 = (framebuffer.image_height - tile.y1 - 0.5f) * v_scale;
+    float v1 = (framebuffer.image_height - tile.y0 + 0.5f) * v_scale;
+    
+    auto direction = [this](float u, float v) {
+        return camera.lower_left_corner + camera.horizontal * u + camera.vertical * v - camera.origin;
+    };
+    const Vec3 edges[4] = {direction(u0, v0), direction(u1, v0), direction(u1, v1), direction(u0, v1)};
+    Vec3 center = direction(0.5f * (u0 + u1), 0.5f * (v0 + v1));
+    
+    Vec3 corners[8];
+    for (int c = 0; c < 8; c++) {
+        corners[c] = Point3(c & 1 ? box.max.x : box.min.x,
+                            c & 2 ? box.max.y : box.min.y,
+                            c & 4 ? box.max.z : box.min.z) - camera.origin;
+    }
+    
+    // The box is out of reach if all its corners lie outside one side plane
+    for (int side = 0; side < 4; side++) {
+        Vec3 normal = edges[side].cross(edges[(side + 1) % 4]);
+        if (normal.dot(center) < 0.0f) {
+            normal = normal * -1.0f;
+        }
+        
+        bool all_outside = true;
+        for (int c = 0; c < 8 && all_outside; c++) {
+            all_outside = normal.dot(corners[c]) < 0.0f;
+        }
+        if (all_outside) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void render_edits(std::unique_ptr<Scene> scene, const RenderOptions& options,
+                  const std::vector<ObjectMove>& moves, float influence_distance, bool check) {
+    std::cerr << "Rendering: " << scene->get_name() << "\n";
+    IncrementalRenderer renderer(*scene, options, influence_distance);
+    const SceneConfig& config = renderer.get_config();
+    int tile_count = renderer.tile_count();
+    std::cerr << "Resolution: " << config.image_width << "x" << config.get_image_height() << "\n";
+    std::cerr << "Samples: " << config.samples_per_pixel << "\n";
+    std::cerr << "Objects: " << renderer.object_count() << "\n";
+    std::cerr << "Influence distance: " << influence_distance << "\n";
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    renderer.render_all();
+    auto end = std::chrono::high_resolution_clock::now();
+    double full_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    std::cerr << "Full render: " << tile_count << " tiles in " << full_ms << " ms\n";
+    
+    for (size_t e = 0; e < moves.size(); e++) {
+        const ObjectMove& move = moves[e];
+        start = std::chrono::high_resolution_clock::now();
+        int rendered = renderer.apply(move);
+        end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        std::cerr << "Edit " << e + 1 << ": object " << move.object << " moved by ("
+                  << move.offset.x << ", " << move.offset.y << ", " << move.offset.z << "), "
+                  << rendered << " of " << tile_count << " tiles rendered again in " << ms << " ms ("
+                  << full_ms / ms << "x faster than a full render)\n";
+        
+        if (check) {
+            // Redone tiles match exactly; what differs is what the tile selection missed
+            Framebuffer reference = renderer.render_reference();
+            const Framebuffer& image = renderer.image();
+            float scale = 1.0f / config.samples_per_pixel;
+            double sum = 0.0;
+            float max_difference = 0.0f;
+            size_t differing = 0;
+            for (size_t i = 0; i < image.pixels.size(); i++) {
+                Color diff = (image.pixels[i] - reference.pixels[i]) * scale;
+                sum += diff.length_squared() / 3.0;
+                max_difference = std::max({max_difference, std::fabs(diff.x), std::fabs(diff.y), std::fabs(diff.z)});
+                differing += diff.length_squared() > 0.0f;
+            }
+            std::cerr << "  Against a full render: " << differing << " pixels differ, RMSE "
+                      << std::sqrt(sum / image.pixels.size()) << ", max difference " << max_difference << "\n";
+        }
+    }
+    
+    TraceScope trace("write image");
+    write_ppm(std::cout, renderer.image(), config.samples_per_pixel);
+}
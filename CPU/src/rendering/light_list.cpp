@@ -0,0 +1,34 @@
+#include "rendering/light_list.h"
+#include "geometry/sphere.h"
+#include "materials/material.h"
+#include <algorithm>
+
+void LightList::build(const std::vector<std::shared_ptr<Hittable>>& objects) {
+    lights.clear();
+    light_set.clear();
+    
+    for (const auto& object : objects) {
+        auto sphere = dynamic_cast<const Sphere*>(object.get());
+        if (sphere && sphere->material && sphere->material->is_emissive()) {
+            lights.push_back(sphere);
+            light_set.insert(sphere);
+        }
+    }
+}
+
+bool LightList::sample(const Point3& ref, float select, const Sample2D& sample,
+                       const Sphere*& light, Vec3& direction, float& pdf) const {
+    if (lights.empty()) return false;
+    
+    size_t index = std::min(static_cast<size_t>(select * lights.size()), lights.size() - 1);
+    light = lights[index];
+    
+    if (!light->sample_solid_angle(ref, sample, direction, pdf)) return false;
+    pdf /= lights.size();
+    return true;
+}
+
+float LightList::pdf(const Point3& ref, const Hittable* object) const {
+    if (light_set.count(object) == 0) return 0.0f;
+    return static_cast<const Sphere*>(object)->solid_angle_pdf(ref) / lights.size();
+}
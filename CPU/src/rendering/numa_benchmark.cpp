@@ -0,0 +1,95 @@
+#include "rendering/numa_benchmark.h"
+#include "utils/numa.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+const int RUNS = 3;
+
+struct Setup {
+    const char* name;
+    bool pin;
+    int max_nodes;
+    bool replicate;
+};
+
+// Best wall time of RUNS frames, in milliseconds
+double time_setup(RenderWorld& world, const Camera& cam, const SceneConfig& config,
+                  const RenderOptions& options, const Setup& setup, int& threads) {
+    const NumaTopology& topology = NumaTopology::get();
+    ThreadPlacement placement;
+    placement.pin = setup.pin;
+    placement.max_nodes = setup.max_nodes;
+    ThreadPool pool(setup.pin ? 0 : topology.cpu_count(), placement);
+    threads = pool.size();
+    
+    if (setup.replicate) {
+        Renderer::replicate_accelerator(world, options.accelerator, pool);
+    }
+    
+    double best = 0.0;
+    for (int run = 0; run < RUNS; run++) {
+        Framebuffer framebuffer(config.image_width, config.get_image_height());
+        auto start = std::chrono::high_resolution_clock::now();
+        Renderer::render_frame(world, cam, config, options, pool, framebuffer);
+        auto end = std::chrono::high_resolution_clock::now();
+        double ms = std::chrono::duration<double, std::milli>(end - start).count();
+        best = (run == 0) ? ms : std::min(best, ms);
+    }
+    
+    world.replicas.clear();
+    world.replica_arenas.clear();
+    return best;
+}
+
+}
+
+void numa_scaling_benchmark(Scene& scene, const RenderOptions& options) {
+    SceneConfig config = scene.get_config();
+    options.apply(config);
+    
+    const NumaTopology& topology = NumaTopology::get();
+    std::cerr << "NUMA scaling on: " << scene.get_name() << "\n";
+    for (int node = 0; node < topology.node_count(); node++) {
+        std::cerr << "  node " << topology.node_ids[node] << ": "
+                  << topology.node_cpus[node].size() << " CPU(s)\n";
+    }
+    
+    auto world = Renderer::build_world(scene, options.accelerator);
+    Camera cam(config.camera_pos, config.camera_target, config.camera_up,
+               config.camera_fov, config.aspect_ratio);
+    
+    const Setup setups[] = {
+        {"one node", true, 1, false},
+        {"all, unpinned", false, 0, false},
+        {"all, pinned", true, 0, false},
+        {"all, replicated", true, 0, true}
+    };
+    
+    double rays = static_cast<double>(config.image_width) * config.get_image_height()
+                * config.samples_per_pixel;
+    double single_node_ms = 0.0;
+    char line[160];
+    snprintf(line, sizeof(line), "\n%-16s %8s %10s %10s %8s\n",
+             "setup", "threads", "time ms", "Mrays/s", "speedup");
+    std::cerr << line;
+    
+    for (const Setup& setup : setups) {
+        int threads = 0;
+        double ms = time_setup(world, cam, config, options, setup, threads);
+        if (single_node_ms == 0.0) {
+            single_node_ms = ms;
+        }
+        snprintf(line, sizeof(line), "%-16s %8d %10.1f %10.3f %7.2fx\n",
+                 setup.name, threads, ms, rays / (ms * 1000.0), single_node_ms / ms);
+        std::cerr << line;
+    }
+    
+    if (topology.node_count() == 1) {
+        std::cerr << "Only one NUMA node: all setups use the same cores and memory.\n";
+    }
+    std::cerr << "Done.\n";
+}
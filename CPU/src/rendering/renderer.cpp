@@ -1,74 +1,132 @@
 #include "rendering/renderer.h"
 #include "rendering/camera.h"
+#include "rendering/denoiser.h"
+#include "rendering/cost_map.h"
 #include "core/kdtree.h"
 #include "core/hittable_list.h"
+#include "core/uniform_grid.h"
+#include "core/traversal_stats.h"
 #include "materials/material.h"
+#include "geometry/sphere.h"
+#include "utils/allocation_counter.h"
 #include "utils/color.h"
+#include "utils/numa.h"
+#include "utils/trace.h"
+#include "simd/kernels.h"
 #include "math/ray.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <future>
 #include <iostream>
-#include <random>
+#include <mutex>
 #include <limits>
+#include <stdexcept>
+#include <sys/resource.h>
 
-void Renderer::render_scene(std::unique_ptr<Scene> scene, bool use_kdtree) {
+namespace {
+
+void print_threads(const ThreadPool& pool) {
+    std::cerr << "Threads: " << pool.size();
+    if (pool.node_count() > 1) {
+        std::cerr << ", pinned across " << pool.node_count() << " NUMA nodes";
+    }
+    std::cerr << "\n";
+}
+
+// A pinned pool renders each node's range of tiles on that node first, so the
+// sample sums of the rows those tiles cover are moved to that node's memory
+void place_rows_on_nodes(Framebuffer& framebuffer, const std::vector<Tile>& tiles, const ThreadPool& pool) {
+    int tile_count = static_cast<int>(tiles.size());
+    for (int node = 0; node < pool.node_count(); node++) {
+        int begin, end;
+        pool.node_range(tile_count, node, begin, end);
+        if (begin >= end) {
+            continue;
+        }
+        size_t first_row = tiles[begin].y0;
+        size_t rows = tiles[end - 1].y1 - first_row;
+        bind_memory_to_node(&framebuffer.pixels[first_row * framebuffer.width],
+                            rows * framebuffer.width * sizeof(Color), node);
+    }
+}
+
+}
+
+ThreadPlacement RenderOptions::thread_placement() const {
+    ThreadPlacement placement;
+    placement.pin = numa;
+    return placement;
+}
+
+void RenderOptions::apply(SceneConfig& config) const {
+    if (image_width > 0) {
+        config.image_width = image_width;
+    }
+    if (samples_per_pixel > 0) {
+        config.samples_per_pixel = samples_per_pixel;
+    }
+}
+
+void Renderer::render_scene(std::unique_ptr<Scene> scene, const RenderOptions& options) {
     // Get scene configuration
     SceneConfig config = scene->get_config();
+    options.apply(config);
     int image_height = config.get_image_height();
     
+    ThreadPool pool(0, options.thread_placement());
+    
     std::cerr << "Rendering: " << scene->get_name() << "\n";
     std::cerr << "Resolution: " << config.image_width << "x" << image_height << "\n";
     std::cerr << "Samples: " << config.samples_per_pixel << "\n";
-    std::cerr << "Acceleration: " << (use_kdtree ? "KD-Tree" : "Linear List") << "\n";
-    
-    // Create objects
-    auto objects = scene->create_objects();
-    std::cerr << "Objects: " << objects.size() << "\n";
-    
-    // Create acceleration structure
-    std::unique_ptr<Hittable> world;
-    if (use_kdtree) {
-        auto kdtree = std::make_unique<KDTree>();
-        kdtree->build(objects);
-        world = std::move(kdtree);
-    } else {
-        auto list = std::make_unique<HittableList>();
-        for (const auto& obj : objects) {
-            list->add(obj);
-        }
-        world = std::move(list);
+    std::cerr << "Acceleration: " << accelerator_name(options.accelerator) << "\n";
+    std::cerr << "Sampler: " << sampler_name(options.sampler) << "\n";
+    std::cerr << "SIMD: " << isa_name(simd_kernels().isa) << "\n";
+    if (options.ambient_occlusion) {
+        std::cerr << "Mode: ambient occlusion, distance " << options.ao_distance << ", "
+                  << (options.ao_closest_hit ? "closest-hit" : "any-hit") << " queries\n";
+    }
+    print_threads(pool);
+    
+    // Create objects and the acceleration structure
+    auto world = build_world(*scene, options.accelerator);
+    if (options.numa_replicate) {
+        replicate_accelerator(world, options.accelerator, pool);
     }
+    std::cerr << "Objects: " << world.objects.size() << "\n";
+    std::cerr << "Lights: " << world.lights.size() << "\n";
     
     // Create camera
     Camera cam(config.camera_pos, config.camera_target, config.camera_up, 
                config.camera_fov, config.aspect_ratio);
     
-    // Random number generation
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
-    
     // Start rendering
     auto render_start = std::chrono::high_resolution_clock::now();
     
-    // Output PPM header
-    std::cout << "P3\n" << config.image_width << ' ' << image_height << "\n255\n";
+    Framebuffer framebuffer(config.image_width, image_height);
+    if (options.denoise) {
+        framebuffer.enable_aovs();
+    }
+    if (!options.heatmap_prefix.empty()) {
+        framebuffer.enable_cost_map();
+    }
+    render_frame(world, cam, config, options, pool, framebuffer, true);
     
-    // Render pixels
-    for (int j = image_height - 1; j >= 0; --j) {
-        std::cerr << "\rScanlines remaining: " << j << " " << std::flush;
-        
-        for (int i = 0; i < config.image_width; ++i) {
-            Color pixel_color(0, 0, 0);
-            
-            // Anti-aliasing samples
-            for (int s = 0; s < config.samples_per_pixel; ++s) {
-                float u = (i + dis(gen)) / (config.image_width - 1);
-                float v = (j + dis(gen)) / (image_height - 1);
-                Ray r = cam.get_ray(u, v);
-                pixel_color = pixel_color + ray_color(r, *world, config.max_depth);
-            }
-            
-            write_color(std::cout, pixel_color, config.samples_per_pixel);
-        }
+    if (options.denoise) {
+        auto denoise_start = std::chrono::high_resolution_clock::now();
+        TraceScope trace("denoise");
+        Denoiser::denoise(framebuffer, config.samples_per_pixel, pool);
+        auto denoise_end = std::chrono::high_resolution_clock::now();
+        std::cerr << "\nDenoised in "
+                  << std::chrono::duration<double, std::milli>(denoise_end - denoise_start).count() << " ms";
+    }
+    
+    {
+        TraceScope trace("write image");
+        write_ppm(std::cout, framebuffer, config.samples_per_pixel);
     }
     
     auto render_end = std::chrono::high_resolution_clock::now();
@@ -78,25 +136,796 @@ void Renderer::render_scene(std::unique_ptr<Scene> scene, bool use_kdtree) {
     print_render_stats(render_start, render_end, 
                       config.image_width * image_height, 
                       config.samples_per_pixel);
+    
+    if (framebuffer.has_cost_map()) {
+        write_cost_maps(options.heatmap_prefix, framebuffer, config.samples_per_pixel);
+    }
+    
+    // Releasing the scene frees the arena blocks rather than each object
+    auto teardown_start = std::chrono::high_resolution_clock::now();
+    {
+        TraceScope trace("release scene");
+        RenderWorld released = std::move(world);  // Destroyed in reverse member order, arena last
+    }
+    auto teardown_end = std::chrono::high_resolution_clock::now();
+    std::cerr << "Scene teardown: "
+              << std::chrono::duration<double, std::milli>(teardown_end - teardown_start).count() << " ms\n";
 }
 
-Color Renderer::ray_color(const Ray& ray, const Hittable& world, int depth) {
-    HitRecord rec;
+void Renderer::render_animation(
+    std::unique_ptr<Scene> scene,
+    const RenderOptions& options,
+    const CameraPath& path,
+    int first_frame,
+    int last_frame,
+    const std::string& output_prefix) {
+    
+    SceneConfig config = scene->get_config();
+    options.apply(config);
+    int image_height = config.get_image_height();
+    int frame_count = last_frame - first_frame + 1;
+    
+    ThreadPool pool(0, options.thread_placement());
+    
+    std::cerr << "Rendering animation: " << scene->get_name() << "\n";
+    std::cerr << "Resolution: " << config.image_width << "x" << image_height << "\n";
+    std::cerr << "Samples: " << config.samples_per_pixel << "\n";
+    std::cerr << "Frames: " << first_frame << "-" << last_frame << "\n";
+    print_threads(pool);
+    
+    // Scene and accelerator are built once for the whole sequence
+    auto world = build_world(*scene, options.accelerator);
+    if (options.numa_replicate) {
+        replicate_accelerator(world, options.accelerator, pool);
+    }
+    
+    auto animation_start = std::chrono::high_resolution_clock::now();
+    
+    // At most one frame is being written while the next one renders
+    std::future<void> pending_write;
+    
+    for (int frame = first_frame; frame <= last_frame; frame++) {
+        auto frame_start = std::chrono::high_resolution_clock::now();
+        
+        path.apply(static_cast<float>(frame), config);
+        Camera cam(config.camera_pos, config.camera_target, config.camera_up,
+                   config.camera_fov, config.aspect_ratio);
+        
+        Framebuffer framebuffer(config.image_width, image_height);
+        if (options.denoise) {
+            framebuffer.enable_aovs();
+        }
+        render_frame(world, cam, config, options, pool, framebuffer);
+        if (options.denoise) {
+            TraceScope trace("denoise");
+            Denoiser::denoise(framebuffer, config.samples_per_pixel, pool);
+        }
+        
+        if (pending_write.valid()) {
+            TraceScope trace("wait for previous write");
+            pending_write.get();  // Rethrows any I/O error from the previous frame
+        }
+        
+        char suffix[16];
+        snprintf(suffix, sizeof(suffix), "_%04d.ppm", frame);
+        std::string filename = output_prefix + suffix;
+        int samples_per_pixel = config.samples_per_pixel;
+        
+        pending_write = std::async(std::launch::async,
+            [filename, samples_per_pixel, framebuffer = std::move(framebuffer)]() {
+                Tracer::set_thread_name("frame writer");
+                TraceScope trace("write frame");
+                std::ofstream out(filename);
+                if (!out) {
+                    throw std::runtime_error("Cannot open output file: " + filename);
+                }
+                write_ppm(out, framebuffer, samples_per_pixel);
+            });
+        
+        auto frame_end = std::chrono::high_resolution_clock::now();
+        double frame_ms = std::chrono::duration<double, std::milli>(frame_end - frame_start).count();
+        std::cerr << "Frame " << frame << " rendered in " << frame_ms << " ms -> " << filename << "\n";
+    }
+    
+    if (pending_write.valid()) {
+        pending_write.get();
+    }
+    
+    auto animation_end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(animation_end - animation_start).count();
+    
+    std::cerr << "Animation completed in " << seconds << " seconds\n";
+    std::cerr << "Sustained frames per second: " << frame_count / seconds << "\n";
+    std::cerr << "Done.\n";
+}
+
+namespace {
+
+// Average of a framebuffer whose tiles hold different sample counts,
+// returned as a one-sample-per-pixel framebuffer
+Framebuffer normalize_tiles(const Framebuffer& sums, const std::vector<Tile>& tiles,
+                            const std::vector<int>& tile_samples) {
+    Framebuffer average(sums.width, sums.height);
+    if (sums.has_aovs()) {
+        average.enable_aovs();
+    }
     
-    // If we've exceeded the ray bounce limit, no more light is gathered
-    if (depth <= 0)
-        return Color(0, 0, 0);
+    for (size_t t = 0; t < tiles.size(); t++) {
+        float scale = 1.0f / tile_samples[t];
+        for (int y = tiles[t].y0; y < tiles[t].y1; y++) {
+            for (int x = tiles[t].x0; x < tiles[t].x1; x++) {
+                size_t index = sums.index(x, y);
+                average.pixels[index] = sums.pixels[index] * scale;
+                if (sums.has_aovs()) {
+                    average.albedo[index] = sums.albedo[index] * scale;
+                    average.normal[index] = sums.normal[index] * scale;
+                    average.depth[index] = sums.depth[index] * scale;
+                }
+            }
+        }
+    }
+    return average;
+}
+
+}
+
+void Renderer::render_progressive(std::unique_ptr<Scene> scene, const RenderOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    
+    SceneConfig config = scene->get_config();
+    options.apply(config);
+    int image_height = config.get_image_height();
     
-    if (world.hit(ray, 0.001f, std::numeric_limits<float>::infinity(), rec)) {
+    ThreadPool pool(0, options.thread_placement());
+    
+    std::cerr << "Progressive rendering: " << scene->get_name() << "\n";
+    std::cerr << "Resolution: " << config.image_width << "x" << image_height << "\n";
+    std::cerr << "Time budget: " << options.time_budget_ms << " ms, up to "
+              << config.samples_per_pixel << " samples\n";
+    print_threads(pool);
+    
+    // The budget covers everything after the process has its scene description
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::milliseconds(options.time_budget_ms);
+    
+    auto world = build_world(*scene, options.accelerator);
+    if (options.numa_replicate) {
+        replicate_accelerator(world, options.accelerator, pool);
+    }
+    Camera cam(config.camera_pos, config.camera_target, config.camera_up,
+               config.camera_fov, config.aspect_ratio);
+    
+    Framebuffer framebuffer(config.image_width, image_height);
+    if (options.denoise) {
+        framebuffer.enable_aovs();
+    }
+    
+    std::vector<Tile> tiles = make_tiles(config.image_width, image_height);
+    std::vector<int> tile_samples(tiles.size(), 0);
+    
+    int pass = 0;
+    int total_samples = 0;
+    bool out_of_time = false;
+    
+    while (total_samples < config.samples_per_pixel && !out_of_time) {
+        // Pass sizes 1, 1, 2, 4, ...: each pass doubles the sample count
+        int pass_samples = std::min(std::max(total_samples, 1), config.samples_per_pixel - total_samples);
+        std::atomic<bool> cancelled(false);
+        TraceScope trace_pass("pass");
+        
+        pool.parallel_for(static_cast<int>(tiles.size()), [&](int t) {
+            if (pass > 0 && (cancelled || Clock::now() >= deadline)) {
+                cancelled = true;
+                return;
+            }
+            render_tile(world, cam, config, options, framebuffer, tiles[t], total_samples, pass_samples);
+            tile_samples[t] += pass_samples;
+        });
+        
+        out_of_time = cancelled || Clock::now() >= deadline;
+        if (!cancelled) {
+            total_samples += pass_samples;
+        }
+        
+        double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        std::cerr << "Pass " << pass << (cancelled ? " (cut short)" : "") << ": "
+                  << total_samples << " spp complete at " << elapsed_ms << " ms\n";
+        
+        if (!options.preview_prefix.empty()) {
+            TraceScope trace("write preview");
+            std::string filename = options.preview_prefix + "_pass" + std::to_string(pass) + ".ppm";
+            std::ofstream out(filename);
+            if (!out) {
+                throw std::runtime_error("Cannot open output file: " + filename);
+            }
+            write_ppm(out, normalize_tiles(framebuffer, tiles, tile_samples), 1);
+        }
+        pass++;
+    }
+    
+    Framebuffer image = normalize_tiles(framebuffer, tiles, tile_samples);
+    if (options.denoise) {
+        TraceScope trace("denoise");
+        Denoiser::denoise(image, 1, pool);
+    }
+    {
+        TraceScope trace("write image");
+        write_ppm(std::cout, image, 1);
+    }
+    
+    double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    std::cerr << "Finished with " << total_samples << "+ spp in " << elapsed_ms << " ms\n";
+    std::cerr << "Done.\n";
+}
+
+void Renderer::render_streaming(std::unique_ptr<Scene> scene, const RenderOptions& options) {
+    SceneConfig config = scene->get_config();
+    options.apply(config);
+    int width = config.image_width;
+    int image_height = config.get_image_height();
+    
+    ThreadPool pool(0, options.thread_placement());
+    
+    // A band is one row of tiles. Only `window` bands have buffers at a time;
+    // a band's slot is reused for the band `window` further down once the
+    // band has been written.
+    int band_count = (image_height + TILE_SIZE - 1) / TILE_SIZE;
+    int tiles_per_band = (width + TILE_SIZE - 1) / TILE_SIZE;
+    int window = options.stream_window > 0 ? options.stream_window : 2 * pool.size();
+    window = std::min(window, band_count);
+    
+    size_t band_bytes = static_cast<size_t>(width) * TILE_SIZE * sizeof(Color);
+    std::cerr << "Streaming render: " << scene->get_name() << "\n";
+    std::cerr << "Resolution: " << width << "x" << image_height << "\n";
+    std::cerr << "Samples: " << config.samples_per_pixel << "\n";
+    std::cerr << "Bands: " << band_count << " of " << TILE_SIZE << " rows, window " << window
+              << " (" << window * band_bytes / (1024 * 1024) << " MB of sample sums)\n";
+    print_threads(pool);
+    
+    auto world = build_world(*scene, options.accelerator);
+    if (options.numa_replicate) {
+        replicate_accelerator(world, options.accelerator, pool);
+    }
+    Camera cam(config.camera_pos, config.camera_target, config.camera_up,
+               config.camera_fov, config.aspect_ratio);
+    
+    auto band_rows = [&](int band) { return std::min(TILE_SIZE, image_height - band * TILE_SIZE); };
+    
+    std::vector<std::unique_ptr<Framebuffer>> slots(window);
+    std::vector<std::atomic<int>> tiles_left(window);
+    for (int band = 0; band < window; band++) {
+        slots[band] = std::make_unique<Framebuffer>(width, band_rows(band), 0, band * TILE_SIZE, width, image_height);
+        tiles_left[band] = tiles_per_band;
+    }
+    
+    std::mutex window_mutex;
+    std::condition_variable window_moved;
+    std::atomic<int> bands_written(0);
+    bool writing = false;   // One thread at a time writes finished bands, in order
+    std::exception_ptr write_error;
+    
+    std::ostream& out = std::cout;
+    out << "P6\n" << width << ' ' << image_height << "\n255\n";
+    
+    auto render_start = std::chrono::high_resolution_clock::now();
+    
+    // Tiles are handed out in image order, so every tile of the oldest
+    // unwritten band is already taken by the time a thread has to wait for
+    // the window to move; those threads never wait, so the window always moves.
+    pool.parallel_for(band_count * tiles_per_band, [&](int index) {
+        int band = index / tiles_per_band;
+        int column = index % tiles_per_band;
+        
+        if (band >= bands_written.load() + window) {
+            TraceScope trace("wait for window", "stream");
+            std::unique_lock<std::mutex> lock(window_mutex);
+            window_moved.wait(lock, [&] { return band < bands_written.load() + window; });
+        }
+        
+        int slot = band % window;
+        int x0 = column * TILE_SIZE;
+        int y0 = band * TILE_SIZE;
+        Tile tile = {x0, y0, std::min(x0 + TILE_SIZE, width), y0 + band_rows(band)};
+        render_tile(world, cam, config, options, *slots[slot], tile, 0, config.samples_per_pixel);
+        
+        if (--tiles_left[slot] > 0) {
+            return;
+        }
+        
+        // Band finished: write it and any later bands already finished behind it
+        std::unique_lock<std::mutex> lock(window_mutex);
+        if (writing) {
+            return;  // The current writer rechecks before it stops
+        }
+        writing = true;
+        while (bands_written.load() < band_count && tiles_left[bands_written.load() % window] == 0) {
+            int next = bands_written.load();
+            Framebuffer& finished = *slots[next % window];
+            lock.unlock();
+            {
+                TraceScope trace("write band", "stream");
+                try {
+                    write_rgb8_rows(out, finished, config.samples_per_pixel);
+                } catch (...) {
+                    write_error = std::current_exception();
+                }
+            }
+            lock.lock();
+            
+            int reuse = next + window;
+            if (reuse < band_count) {
+                slots[next % window] = std::make_unique<Framebuffer>(width, band_rows(reuse), 0, reuse * TILE_SIZE,
+                                                                        width, image_height);
+                tiles_left[next % window] = tiles_per_band;
+            }
+            bands_written = next + 1;
+            window_moved.notify_all();
+            std::cerr << "\rBands written: " << next + 1 << "/" << band_count << " " << std::flush;
+        }
+        writing = false;
+    });
+    
+    out.flush();
+    if (write_error) {
+        std::rethrow_exception(write_error);
+    }
+    if (!out) {
+        throw std::runtime_error("Failed writing streamed image");
+    }
+    
+    auto render_end = std::chrono::high_resolution_clock::now();
+    std::cerr << "\n";
+    
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        std::cerr << "Peak resident memory: " << usage.ru_maxrss / 1024 << " MB\n";
+    }
+    print_render_stats(render_start, render_end, width * image_height, config.samples_per_pixel);
+}
+
+namespace {
+
+// An object counts as huge when it is this many times larger than the median object
+const float HUGE_OBJECT_RATIO = 50.0f;
+
+float max_extent(const BoundingBox& box) {
+    Vec3 size = box.size();
+    return std::max(size.x, std::max(size.y, size.z));
+}
+
+// Separate unbounded (infinite box) and huge objects from the rest
+void split_unbounded(const std::vector<std::shared_ptr<Hittable>>& objects,
+                     std::vector<std::shared_ptr<Hittable>>& bounded,
+                     std::vector<std::shared_ptr<Hittable>>& unbounded) {
+    std::vector<float> extents;
+    extents.reserve(objects.size());
+    for (const auto& obj : objects) {
+        extents.push_back(max_extent(obj->bounding_box()));
+    }
+    
+    std::vector<float> sorted = extents;
+    std::sort(sorted.begin(), sorted.end());
+    float limit = sorted.empty() ? 0.0f : sorted[sorted.size() / 2] * HUGE_OBJECT_RATIO;
+    
+    for (size_t i = 0; i < objects.size(); i++) {
+        bool huge = !std::isfinite(extents[i]) || (limit > 0.0f && extents[i] > limit);
+        (huge ? unbounded : bounded).push_back(objects[i]);
+    }
+}
+
+}
+
+RenderWorld Renderer::build_world(Scene& scene, AcceleratorType accelerator, bool quiet) {
+    size_t heap_before = heap_allocation_count();
+    auto scene_start = std::chrono::high_resolution_clock::now();
+    
+    RenderWorld world;
+    {
+        TraceScope trace("create scene");
+        world.arena = std::make_shared<SceneArena>();
+        world.objects = scene.create_objects(*world.arena);
+        world.lights.build(world.objects);
+    }
+    
+    auto build_start = std::chrono::high_resolution_clock::now();
+    TraceScope trace_build("build accelerator");
+    
+    world.accelerator = build_accelerator(world.objects, accelerator, world.arena.get(), quiet);
+    if (quiet) {
+        return world;
+    }
+    
+    auto build_end = std::chrono::high_resolution_clock::now();
+    std::cerr << "Scene setup time: "
+              << std::chrono::duration<double, std::milli>(build_start - scene_start).count() << " ms\n";
+    std::cerr << accelerator_name(accelerator) << " build time: "
+              << std::chrono::duration<double, std::milli>(build_end - build_start).count() << " ms\n";
+    std::cerr << "Scene arena: " << world.arena->allocation_count() << " allocations in "
+              << world.arena->block_count() << " blocks, "
+              << world.arena->bytes_reserved() / 1024 << " KB\n";
+    std::cerr << "Heap allocations during setup: " << heap_allocation_count() - heap_before << "\n";
+    return world;
+}
+
+std::shared_ptr<Hittable> Renderer::build_accelerator(
+    const std::vector<std::shared_ptr<Hittable>>& objects,
+    AcceleratorType accelerator,
+    SceneArena* arena,
+    bool quiet) {
+    
+    // Planes and ground-sized spheres would stretch the accelerator's bounds
+    // and overlap every node or cell, so they are tested on their own
+    std::vector<std::shared_ptr<Hittable>> bounded, unbounded;
+    split_unbounded(objects, bounded, unbounded);
+    
+    std::shared_ptr<Hittable> result;
+    if (accelerator == AcceleratorType::KDTree || accelerator == AcceleratorType::KDTreeQuantized16 ||
+        accelerator == AcceleratorType::KDTreeQuantized8) {
+        KDNodeFormat format = accelerator == AcceleratorType::KDTreeQuantized16 ? KDNodeFormat::Quantized16
+                            : accelerator == AcceleratorType::KDTreeQuantized8 ? KDNodeFormat::Quantized8
+                            : KDNodeFormat::Full;
+        auto kdtree = std::make_shared<KDTree>(format);
+        kdtree->build(bounded, arena, quiet);
+        result = kdtree;
+    } else if (accelerator == AcceleratorType::Grid) {
+        auto grid = std::make_shared<UniformGrid>();
+        grid->build(bounded, quiet);
+        result = grid;
+    }
+    
+    if (!result || !unbounded.empty()) {
+        auto list = std::make_shared<HittableList>();
+        if (result) {
+            list->add(result);
+            for (const auto& obj : unbounded) {
+                list->add(obj);
+            }
+            if (!quiet) {
+                std::cerr << "Objects outside the accelerator: " << unbounded.size() << "\n";
+            }
+        } else {
+            for (const auto& obj : objects) {
+                list->add(obj);
+            }
+        }
+        result = list;
+    }
+    return result;
+}
+
+void Renderer::replicate_accelerator(RenderWorld& world, AcceleratorType accelerator, const ThreadPool& pool) {
+    TraceScope trace("replicate accelerator");
+    // Copies from an earlier call go first, before the arenas they live in
+    world.replicas.clear();
+    world.replica_arenas.clear();
+    world.replicas.resize(pool.node_count());
+    
+    // Node 0 keeps the original. Each copy is built by a thread on its node,
+    // so its nodes and leaf arrays are first touched, and placed, there.
+    for (int node = 1; node < pool.node_count(); node++) {
+        run_on_node(node, [&] {
+            auto arena = std::make_shared<SceneArena>();
+            world.replicas[node] = build_accelerator(world.objects, accelerator, arena.get());
+            world.replica_arenas.push_back(arena);
+        });
+    }
+    if (pool.node_count() > 1) {
+        std::cerr << "Accelerator replicated on " << pool.node_count() - 1 << " more NUMA node(s)\n";
+    }
+}
+
+std::vector<Tile> Renderer::make_tiles(int width, int height) {
+    std::vector<Tile> tiles;
+    for (int y0 = 0; y0 < height; y0 += TILE_SIZE) {
+        for (int x0 = 0; x0 < width; x0 += TILE_SIZE) {
+            tiles.push_back({x0, y0, std::min(x0 + TILE_SIZE, width), std::min(y0 + TILE_SIZE, height)});
+        }
+    }
+    return tiles;
+}
+
+void Renderer::render_frame(
+    const RenderWorld& world,
+    const Camera& cam,
+    const SceneConfig& config,
+    const RenderOptions& options,
+    ThreadPool& pool,
+    Framebuffer& framebuffer,
+    bool show_progress) {
+    
+    std::vector<Tile> tiles = make_tiles(framebuffer.width, framebuffer.height);
+    int tile_count = static_cast<int>(tiles.size());
+    
+    std::atomic<int> tiles_done(0);
+    std::mutex progress_mutex;
+    TraceScope trace("render frame");
+    
+    if (pool.node_count() > 1) {
+        place_rows_on_nodes(framebuffer, tiles, pool);
+    }
+    
+    pool.parallel_for(tile_count, [&](int tile) {
+        render_tile(world, cam, config, options, framebuffer, tiles[tile], 0, config.samples_per_pixel);
+        
+        int done = ++tiles_done;
+        if (show_progress) {
+            std::lock_guard<std::mutex> lock(progress_mutex);
+            std::cerr << "\rTiles remaining: " << tile_count - done << " " << std::flush;
+        }
+    });
+}
+
+void Renderer::render_tile(
+    const RenderWorld& world,
+    const Camera& cam,
+    const SceneConfig& config,
+    const RenderOptions& options,
+    Framebuffer& framebuffer,
+    const Tile& tile,
+    int first_sample,
+    int sample_count,
+    TileFirstHits* first_hits) {
+    
+    TraceScope trace("tile", "tile", tile.x0, tile.y0);
+    
+    // Samplers are stateless across pixels, so one per tile is enough
+    auto sampler = make_sampler(options.sampler, config.samples_per_pixel, options.seed);
+    
+    // Camera coordinates span the whole image, not just the framebuffer's region
+    int width = framebuffer.image_width;
+    int height = framebuffer.image_height;
+    bool capture_aovs = framebuffer.has_aovs();
+    bool capture_cost = framebuffer.has_cost_map();
+    bool need_aov = capture_aovs || first_hits;
+    
+    if (first_hits) {
+        const float infinity = std::numeric_limits<float>::infinity();
+        BoundingBox empty(Point3(infinity, infinity, infinity), Point3(-infinity, -infinity, -infinity));
+        first_hits->objects.clear();
+        first_hits->pixel_bounds.assign(static_cast<size_t>(tile.x1 - tile.x0) * (tile.y1 - tile.y0), empty);
+    }
+    
+    // Each tile row is summed locally, then added to the framebuffer in one
+    // SIMD pass, so the shared framebuffer is touched once per row
+    static_assert(sizeof(Color) == 3 * sizeof(float), "Color must be three packed floats");
+    const SimdKernels& kernels = simd_kernels();
+    Color row_sums[TILE_SIZE];
+    
+    for (int y = tile.y0; y < tile.y1; ++y) {
+        int j = height - 1 - y;  // Image rows run top-down, v runs bottom-up
+        
+        for (int i = tile.x0; i < tile.x1; ++i) {
+            Color& pixel_color = row_sums[i - tile.x0];
+            pixel_color = Color(0, 0, 0);
+            SurfaceAov aov_sum = {Color(0, 0, 0), Vec3(0, 0, 0), 0.0f, Point3(0, 0, 0), nullptr};
+            
+            TraversalStats stats_before = traversal_stats;
+            uint64_t cycles_before = capture_cost ? read_cycle_counter() : 0;
+            
+            // Anti-aliasing samples
+            for (int s = first_sample; s < first_sample + sample_count; ++s) {
+                sampler->start_pixel_sample(i, j, s);
+                Sample2D jitter = sampler->get_2d();
+                float u = (i + jitter.u) / (width - 1);
+                float v = (j + jitter.v) / (height - 1);
+                Ray r = cam.get_ray(u, v);
+                
+                SurfaceAov aov;
+                SurfaceAov* aov_out = need_aov ? &aov : nullptr;
+                if (options.ambient_occlusion) {
+                    pixel_color = pixel_color + ambient_occlusion(r, world, options, *sampler, aov_out);
+                } else {
+                    pixel_color = pixel_color + ray_color(r, world, config, *sampler, aov_out);
+                }
+                
+                if (capture_aovs) {
+                    aov_sum.albedo = aov_sum.albedo + aov.albedo;
+                    aov_sum.normal = aov_sum.normal + aov.normal;
+                    aov_sum.depth += aov.depth;
+                }
+                if (first_hits && aov.object) {
+                    // Consecutive samples mostly hit the same primitive; duplicates are removed below
+                    if (first_hits->objects.empty() || first_hits->objects.back() != aov.object) {
+                        first_hits->objects.push_back(aov.object);
+                    }
+                    BoundingBox& bounds = first_hits->pixel_bounds[(y - tile.y0) * (tile.x1 - tile.x0) + (i - tile.x0)];
+                    bounds.min = Point3(std::min(bounds.min.x, aov.position.x), std::min(bounds.min.y, aov.position.y),
+                                        std::min(bounds.min.z, aov.position.z));
+                    bounds.max = Point3(std::max(bounds.max.x, aov.position.x), std::max(bounds.max.y, aov.position.y),
+                                        std::max(bounds.max.z, aov.position.z));
+                }
+            }
+            
+            if (capture_aovs) {
+                size_t index = framebuffer.index(i, y);
+                framebuffer.albedo[index] = framebuffer.albedo[index] + aov_sum.albedo;
+                framebuffer.normal[index] = framebuffer.normal[index] + aov_sum.normal;
+                framebuffer.depth[index] += aov_sum.depth;
+            }
+            
+            if (capture_cost) {
+                PixelCost& cost = framebuffer.cost[framebuffer.index(i, y)];
+                cost.cycles += static_cast<float>(read_cycle_counter() - cycles_before);
+                cost.nodes += static_cast<float>(traversal_stats.nodes_visited - stats_before.nodes_visited);
+                cost.primitives += static_cast<float>(traversal_stats.primitive_tests - stats_before.primitive_tests);
+                cost.bounces += static_cast<float>(traversal_stats.bounces - stats_before.bounces);
+            }
+        }
+        
+        kernels.accumulate(&framebuffer.pixels[framebuffer.index(tile.x0, y)].x, &row_sums[0].x,
+                           3 * static_cast<size_t>(tile.x1 - tile.x0));
+    }
+    
+    if (first_hits) {
+        std::vector<const Hittable*>& objects = first_hits->objects;
+        std::sort(objects.begin(), objects.end());
+        objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+    }
+}
+
+namespace {
+
+// Balance heuristic squared (Veach's power heuristic with beta = 2)
+inline float power_heuristic(float pdf_a, float pdf_b) {
+    float a2 = pdf_a * pdf_a;
+    float b2 = pdf_b * pdf_b;
+    return a2 + b2 > 0.0f ? a2 / (a2 + b2) : 0.0f;
+}
+
+inline Color multiply(const Color& a, const Color& b) {
+    return Color(a.x * b.x, a.y * b.y, a.z * b.z);
+}
+
+}
+
+Color Renderer::ray_color(
+    const Ray& camera_ray,
+    const RenderWorld& world,
+    const SceneConfig& config,
+    Sampler& sampler,
+    SurfaceAov* aov) {
+    
+    const float infinity = std::numeric_limits<float>::infinity();
+    const bool sample_lights = !world.lights.empty();
+    
+    Color radiance(0, 0, 0);
+    Color throughput(1, 1, 1);
+    Ray ray = camera_ray;
+    
+    // Where the previous bounce was sampled from, for MIS on emitters hit by BSDF sampling
+    Point3 previous_point;
+    float previous_bsdf_pdf = 0.0f;
+    
+    for (int bounce = 0; bounce < config.max_depth; bounce++) {
+        traversal_stats.bounces++;
+        HitRecord rec;
+        if (!world.local_accelerator().hit(ray, 0.001f, infinity, rec)) {
+            Color sky = background(ray, config);
+            if (aov && bounce == 0) {
+                // The background is its own albedo, so it demodulates to a flat 1
+                aov->albedo = sky;
+                aov->normal = ray.direction.normalize() * -1.0f;
+                aov->depth = MISS_DEPTH;
+                aov->object = nullptr;
+            }
+            radiance = radiance + multiply(throughput, sky);
+            break;
+        }
+        
+        if (aov && bounce == 0) {
+            aov->albedo = rec.material->base_color();
+            aov->normal = rec.normal;
+            aov->depth = rec.t * ray.direction.length();
+            aov->position = rec.point;
+            aov->object = rec.object;
+        }
+        
+        // Emission reached by BSDF sampling; weighted against the light sample
+        // that could have produced the same direction
+        if (rec.material->is_emissive()) {
+            Color emission = rec.material->emitted(rec);
+            float weight = 1.0f;
+            if (bounce > 0 && sample_lights) {
+                float light_pdf = world.lights.pdf(previous_point, rec.object);
+                weight = power_heuristic(previous_bsdf_pdf, light_pdf);
+            }
+            radiance = radiance + multiply(throughput, emission) * weight;
+            break;
+        }
+        
+        // Next-event estimation: one explicit sample toward a light
+        if (sample_lights) {
+            float select = sampler.get_1d();
+            Sample2D light_sample = sampler.get_2d();
+            
+            const Sphere* light;
+            Vec3 direction;
+            float light_pdf;
+            if (world.lights.sample(rec.point, select, light_sample, light, direction, light_pdf)) {
+                Color f = rec.material->eval(rec, direction);
+                
+                HitRecord light_rec;
+                Ray shadow_ray(rec.point, direction);
+                
+                // Visible if nothing blocks the segment up to the chosen light; only
+                // the light itself needs a full intersection, the rest is any-hit
+                if ((f.x > 0.0f || f.y > 0.0f || f.z > 0.0f) &&
+                    light->hit(shadow_ray, 0.001f, infinity, light_rec) &&
+                    !world.local_accelerator().occluded(shadow_ray, 0.001f, light_rec.t * SHADOW_EPSILON_SCALE)) {
+                    float bsdf_pdf = rec.material->pdf(rec, direction);
+                    float weight = power_heuristic(light_pdf, bsdf_pdf);
+                    Color emission = light_rec.material->emitted(light_rec);
+                    radiance = radiance + multiply(throughput, multiply(f, emission)) * (weight / light_pdf);
+                }
+            }
+        }
+        
         Ray scattered;
         Color attenuation;
-        if (rec.material->scatter(ray, rec, attenuation, scattered)) {
-            Color scattered_color = ray_color(scattered, world, depth - 1);
-            return Color(attenuation.x * scattered_color.x, 
-                        attenuation.y * scattered_color.y, 
-                        attenuation.z * scattered_color.z);
+        if (!rec.material->scatter(ray, rec, sampler, attenuation, scattered)) {
+            break;
+        }
+        
+        previous_point = rec.point;
+        previous_bsdf_pdf = rec.material->pdf(rec, scattered.direction);
+        throughput = multiply(throughput, attenuation);
+        ray = scattered;
+    }
+    
+    return radiance;
+}
+
+Color Renderer::ambient_occlusion(
+    const Ray& ray,
+    const RenderWorld& world,
+    const RenderOptions& options,
+    Sampler& sampler,
+    SurfaceAov* aov) {
+    
+    const float infinity = std::numeric_limits<float>::infinity();
+    const Color white(1, 1, 1);
+    
+    HitRecord rec;
+    if (!world.local_accelerator().hit(ray, 0.001f, infinity, rec)) {
+        if (aov) {
+            aov->albedo = white;
+            aov->normal = ray.direction.normalize() * -1.0f;
+            aov->depth = MISS_DEPTH;
+            aov->object = nullptr;
         }
-        return Color(0, 0, 0);
+        return white;
+    }
+    
+    if (aov) {
+        aov->albedo = white;
+        aov->normal = rec.normal;
+        aov->depth = rec.t * ray.direction.length();
+        aov->position = rec.point;
+        aov->object = rec.object;
+    }
+    
+    // normal + uniform unit vector is cosine distributed, so the visible
+    // fraction is the cosine-weighted AO estimate
+    Sample2D sample = sampler.get_2d();
+    float a = sample.u * 2.0f * M_PI;
+    float z = sample.v * 2.0f - 1.0f;
+    float r = sqrt(1.0f - z * z);
+    Vec3 direction = (rec.normal + Vec3(r * cos(a), r * sin(a), z)).normalize();
+    
+    Ray ao_ray(rec.point, direction);
+    bool blocked;
+    if (options.ao_closest_hit) {
+        HitRecord blocker;
+        blocked = world.local_accelerator().hit(ao_ray, 0.001f, options.ao_distance, blocker);
+    } else {
+        blocked = world.local_accelerator().occluded(ao_ray, 0.001f, options.ao_distance);
+    }
+    return blocked ? Color(0, 0, 0) : white;
+}
+
+Color Renderer::background(const Ray& ray, const SceneConfig& config) {
+    if (!config.sky) {
+        return config.background;
     }
     
     // Background gradient
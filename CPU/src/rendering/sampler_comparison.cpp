@@ -0,0 +1,97 @@
+#include "rendering/sampler_comparison.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+
+struct TimedRender {
+    Framebuffer framebuffer;
+    double milliseconds;
+};
+
+TimedRender timed_render(const RenderWorld& world, const Camera& cam, SceneConfig config,
+                         RenderOptions options, SamplerType sampler, int spp, ThreadPool& pool) {
+    config.samples_per_pixel = spp;
+    options.sampler = sampler;
+    
+    TimedRender result = {Framebuffer(config.image_width, config.get_image_height()), 0.0};
+    auto start = std::chrono::high_resolution_clock::now();
+    Renderer::render_frame(world, cam, config, options, pool, result.framebuffer);
+    auto end = std::chrono::high_resolution_clock::now();
+    result.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
+
+// Root-mean-square error of the averaged linear colors
+double rmse(const Framebuffer& image, int spp, const Framebuffer& reference, int reference_spp) {
+    double sum = 0.0;
+    for (size_t i = 0; i < image.pixels.size(); i++) {
+        Color diff = image.pixels[i] / static_cast<float>(spp)
+                   - reference.pixels[i] / static_cast<float>(reference_spp);
+        sum += diff.length_squared() / 3.0;
+    }
+    return std::sqrt(sum / image.pixels.size());
+}
+
+}
+
+void compare_samplers(Scene& scene, const RenderOptions& options, int reference_spp) {
+    SceneConfig config = scene.get_config();
+    options.apply(config);
+    int base_spp = options.samples_per_pixel > 0 ? options.samples_per_pixel : 16;
+    
+    ThreadPool pool(0, options.thread_placement());
+    auto world = Renderer::build_world(scene, options.accelerator);
+    if (options.numa_replicate) {
+        Renderer::replicate_accelerator(world, options.accelerator, pool);
+    }
+    Camera cam(config.camera_pos, config.camera_target, config.camera_up,
+               config.camera_fov, config.aspect_ratio);
+    
+    std::cerr << "Comparing samplers on: " << scene.get_name() << "\n";
+    std::cerr << "Rendering reference at " << reference_spp << " spp (sobol)...\n";
+    
+    // A different seed keeps the reference noise independent of the test images
+    RenderOptions reference_options = options;
+    reference_options.seed = options.seed + 0x5eed;
+    TimedRender reference = timed_render(world, cam, config, reference_options,
+                                         SamplerType::Sobol, reference_spp, pool);
+    std::cerr << "Reference done in " << reference.milliseconds << " ms\n\n";
+    
+    const SamplerType samplers[] = {
+        SamplerType::Independent, SamplerType::Stratified, SamplerType::Halton,
+        SamplerType::Sobol, SamplerType::BlueNoise
+    };
+    
+    double budget_ms = 0.0;
+    char line[160];
+    snprintf(line, sizeof(line), "%-12s %8s %10s %10s   %8s %10s %10s\n",
+             "sampler", "spp", "time ms", "RMSE", "eq-t spp", "time ms", "RMSE");
+    std::cerr << line;
+    
+    for (SamplerType sampler : samplers) {
+        TimedRender fixed = timed_render(world, cam, config, options, sampler, base_spp, pool);
+        double fixed_error = rmse(fixed.framebuffer, base_spp, reference.framebuffer, reference_spp);
+        
+        // The independent sampler's time at the base sample count sets the budget
+        if (budget_ms == 0.0) {
+            budget_ms = fixed.milliseconds;
+        }
+        
+        int equal_time_spp = std::max(1, static_cast<int>(std::lround(base_spp * budget_ms / fixed.milliseconds)));
+        TimedRender equal_time = (equal_time_spp == base_spp)
+            ? fixed
+            : timed_render(world, cam, config, options, sampler, equal_time_spp, pool);
+        double equal_time_error = rmse(equal_time.framebuffer, equal_time_spp, reference.framebuffer, reference_spp);
+        
+        snprintf(line, sizeof(line), "%-12s %8d %10.1f %10.5f   %8d %10.1f %10.5f\n",
+                 sampler_name(sampler), base_spp, fixed.milliseconds, fixed_error,
+                 equal_time_spp, equal_time.milliseconds, equal_time_error);
+        std::cerr << line;
+    }
+    
+    std::cerr << "Done.\n";
+}
@@ -0,0 +1,183 @@
+#include "rendering/thread_pool.h"
+#include "utils/numa.h"
+#include "utils/trace.h"
+#include <algorithm>
+#include <string>
+
+ThreadPool::ThreadPool(int num_threads, ThreadPlacement placement)
+    : current_task(nullptr), task_count(0), next_index(0),
+      busy_workers(0), generation(0), stopping(false), task_failed(false) {
+    
+    if (placement.pin) {
+        const NumaTopology& topology = NumaTopology::get();
+        int nodes = topology.node_count();
+        if (placement.max_nodes > 0) {
+            nodes = std::min(nodes, placement.max_nodes);
+        }
+        
+        // Cores in node order, so a pool smaller than the machine spans as few nodes as it can
+        std::vector<int> cpus, cpu_nodes;
+        for (int node = 0; node < nodes; node++) {
+            for (int cpu : topology.node_cpus[node]) {
+                cpus.push_back(cpu);
+                cpu_nodes.push_back(node);
+            }
+        }
+        if (num_threads <= 0) {
+            num_threads = static_cast<int>(cpus.size());
+        }
+        
+        threads_per_node.assign(nodes, 0);
+        for (int i = 0; i < num_threads; i++) {
+            int slot = i % static_cast<int>(cpus.size());
+            thread_cpus.push_back(cpus[slot]);
+            thread_nodes.push_back(cpu_nodes[slot]);
+            threads_per_node[cpu_nodes[slot]]++;
+        }
+        while (threads_per_node.size() > 1 && threads_per_node.back() == 0) {
+            threads_per_node.pop_back();
+        }
+        node_next.reset(new std::atomic<int>[threads_per_node.size()]);
+        node_end.assign(threads_per_node.size(), 0);
+        
+        caller_cpus = current_thread_cpus();
+        pin_current_thread({thread_cpus[0]}, thread_nodes[0]);
+    } else if (num_threads <= 0) {
+        num_threads = static_cast<int>(std::thread::hardware_concurrency());
+        if (num_threads <= 0) num_threads = 1;
+    }
+    
+    for (int i = 1; i < num_threads; i++) {
+        workers.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    work_available.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (!caller_cpus.empty()) {
+        pin_current_thread(caller_cpus, 0);
+    }
+}
+
+int ThreadPool::size() const {
+    return static_cast<int>(workers.size()) + 1;
+}
+
+int ThreadPool::node_count() const {
+    return threads_per_node.empty() ? 1 : static_cast<int>(threads_per_node.size());
+}
+
+void ThreadPool::node_range(int count, int node, int& begin, int& end) const {
+    if (threads_per_node.empty()) {
+        begin = 0;
+        end = count;
+        return;
+    }
+    
+    int before = 0;
+    for (int n = 0; n < node; n++) {
+        before += threads_per_node[n];
+    }
+    int through = before + threads_per_node[node];
+    begin = static_cast<int>(static_cast<long long>(count) * before / size());
+    end = static_cast<int>(static_cast<long long>(count) * through / size());
+}
+
+void ThreadPool::parallel_for(int count, const std::function<void(int)>& task) {
+    std::unique_lock<std::mutex> lock(mutex);
+    current_task = &task;
+    task_count = count;
+    next_index = 0;
+    task_failed = false;
+    for (size_t node = 0; node < node_end.size(); node++) {
+        int begin, end;
+        node_range(count, static_cast<int>(node), begin, end);
+        node_next[node] = begin;
+        node_end[node] = end;
+    }
+    busy_workers = static_cast<int>(workers.size());
+    generation++;
+    lock.unlock();
+    work_available.notify_all();
+    
+    // The caller works too instead of just waiting
+    run_tasks();
+    
+    // Time spent here is load imbalance: other threads still finishing tasks
+    TraceScope wait("wait for workers", "pool");
+    lock.lock();
+    work_done.wait(lock, [this] { return busy_workers == 0; });
+    current_task = nullptr;
+    
+    if (task_error) {
+        std::exception_ptr error = task_error;
+        task_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::worker_loop(int index) {
+    unsigned long seen_generation = 0;
+    Tracer::set_thread_name("worker " + std::to_string(index));
+    if (!thread_cpus.empty()) {
+        pin_current_thread({thread_cpus[index]}, thread_nodes[index]);
+    }
+    
+    while (true) {
+        {
+            TraceScope idle("idle", "pool");
+            std::unique_lock<std::mutex> lock(mutex);
+            work_available.wait(lock, [&] { return stopping || generation != seen_generation; });
+            if (stopping) return;
+            seen_generation = generation;
+        }
+        
+        run_tasks();
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busy_workers == 0) {
+                work_done.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::run_tasks() {
+    int nodes = static_cast<int>(node_end.size());
+    if (nodes > 1) {
+        // This node's range first, then help the others
+        for (int k = 0; k < nodes; k++) {
+            int node = (thread_numa_node + k) % nodes;
+            int index;
+            while (!task_failed && (index = node_next[node].fetch_add(1)) < node_end[node]) {
+                run_task(index);
+            }
+        }
+        return;
+    }
+    
+    int index;
+    while (!task_failed && (index = next_index.fetch_add(1)) < task_count) {
+        run_task(index);
+    }
+}
+
+void ThreadPool::run_task(int index) {
+    try {
+        (*current_task)(index);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!task_error) {
+            task_error = std::current_exception();
+        }
+        task_failed = true;
+    }
+}
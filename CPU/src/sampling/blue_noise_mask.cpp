@@ -0,0 +1,124 @@
+#include "sampling/blue_noise_mask.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+const int N = BlueNoiseMask::SIZE * BlueNoiseMask::SIZE;
+
+// Gaussian energy field of the set pixels, with toroidal distances
+class EnergyField {
+public:
+    EnergyField() : energy(N, 0.0f), kernel(N) {
+        const float sigma = 1.5f;
+        for (int dy = 0; dy < BlueNoiseMask::SIZE; dy++) {
+            for (int dx = 0; dx < BlueNoiseMask::SIZE; dx++) {
+                int wx = std::min(dx, BlueNoiseMask::SIZE - dx);
+                int wy = std::min(dy, BlueNoiseMask::SIZE - dy);
+                kernel[dy * BlueNoiseMask::SIZE + dx] = std::exp(-(wx * wx + wy * wy) / (2.0f * sigma * sigma));
+            }
+        }
+    }
+    
+    void splat(int pixel, float sign) {
+        int px = pixel % BlueNoiseMask::SIZE;
+        int py = pixel / BlueNoiseMask::SIZE;
+        for (int y = 0; y < BlueNoiseMask::SIZE; y++) {
+            int dy = (y - py) & (BlueNoiseMask::SIZE - 1);
+            for (int x = 0; x < BlueNoiseMask::SIZE; x++) {
+                int dx = (x - px) & (BlueNoiseMask::SIZE - 1);
+                energy[y * BlueNoiseMask::SIZE + x] += sign * kernel[dy * BlueNoiseMask::SIZE + dx];
+            }
+        }
+    }
+    
+    // Set pixel with the highest energy
+    int tightest_cluster(const std::vector<bool>& set) const {
+        int best = -1;
+        for (int i = 0; i < N; i++) {
+            if (set[i] && (best < 0 || energy[i] > energy[best])) best = i;
+        }
+        return best;
+    }
+    
+    // Empty pixel with the lowest energy
+    int largest_void(const std::vector<bool>& set) const {
+        int best = -1;
+        for (int i = 0; i < N; i++) {
+            if (!set[i] && (best < 0 || energy[i] < energy[best])) best = i;
+        }
+        return best;
+    }
+    
+private:
+    std::vector<float> energy;
+    std::vector<float> kernel;
+};
+
+}
+
+const BlueNoiseMask& BlueNoiseMask::instance() {
+    static const BlueNoiseMask mask;
+    return mask;
+}
+
+BlueNoiseMask::BlueNoiseMask() : values(N) {
+    std::mt19937 gen(7);  // Fixed seed: the mask is identical on every run
+    std::uniform_int_distribution<int> pick(0, N - 1);
+    
+    // Initial binary pattern: 10% random points, relaxed by moving the point in
+    // the tightest cluster into the largest void until that is a no-op
+    std::vector<bool> pattern(N, false);
+    EnergyField field;
+    int initial_count = N / 10;
+    for (int placed = 0; placed < initial_count; ) {
+        int p = pick(gen);
+        if (!pattern[p]) {
+            pattern[p] = true;
+            field.splat(p, 1.0f);
+            placed++;
+        }
+    }
+    
+    while (true) {
+        int cluster = field.tightest_cluster(pattern);
+        pattern[cluster] = false;
+        field.splat(cluster, -1.0f);
+        
+        int empty = field.largest_void(pattern);
+        pattern[empty] = true;
+        field.splat(empty, 1.0f);
+        
+        if (empty == cluster) break;
+    }
+    
+    std::vector<int> rank(N, 0);
+    
+    // Phase 1: rank the initial points by removing tightest clusters
+    {
+        std::vector<bool> remaining = pattern;
+        EnergyField phase_field;
+        for (int i = 0; i < N; i++) {
+            if (remaining[i]) phase_field.splat(i, 1.0f);
+        }
+        for (int r = initial_count - 1; r >= 0; r--) {
+            int cluster = phase_field.tightest_cluster(remaining);
+            remaining[cluster] = false;
+            phase_field.splat(cluster, -1.0f);
+            rank[cluster] = r;
+        }
+    }
+    
+    // Phase 2: fill the largest voids until every pixel has a rank
+    for (int r = initial_count; r < N; r++) {
+        int empty = field.largest_void(pattern);
+        pattern[empty] = true;
+        field.splat(empty, 1.0f);
+        rank[empty] = r;
+    }
+    
+    for (int i = 0; i < N; i++) {
+        values[i] = (rank[i] + 0.5f) / N;
+    }
+}
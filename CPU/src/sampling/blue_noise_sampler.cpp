@@ -0,0 +1,47 @@
+#include "sampling/blue_noise_sampler.h"
+#include "sampling/blue_noise_mask.h"
+#include "sampling/sample_math.h"
+
+namespace {
+
+inline float wrap(float v) {
+    return clamp_unit(v >= 1.0f ? v - 1.0f : v);
+}
+
+}
+
+BlueNoiseSampler::BlueNoiseSampler(uint32_t seed)
+    : seed(seed), pixel_x(0), pixel_y(0), index(0), dimension(0) {
+    BlueNoiseMask::instance();  // Build the mask before rendering starts
+}
+
+void BlueNoiseSampler::start_pixel_sample(int x, int y, int sample_index) {
+    pixel_x = x;
+    pixel_y = y;
+    index = sample_index;
+    dimension = 0;
+}
+
+float BlueNoiseSampler::mask_offset(uint32_t dim) const {
+    // R2 low-discrepancy shifts keep the per-dimension masks decorrelated
+    int shift_x = static_cast<int>(dim * 0.7548776662f * BlueNoiseMask::SIZE);
+    int shift_y = static_cast<int>(dim * 0.5698402910f * BlueNoiseMask::SIZE);
+    return BlueNoiseMask::instance().value(pixel_x + shift_x, pixel_y + shift_y);
+}
+
+float BlueNoiseSampler::get_1d() {
+    uint32_t dim_seed = hash_combine(seed, dimension);
+    uint32_t shuffled = nested_uniform_scramble(index, dim_seed);
+    float value = to_unit_float(nested_uniform_scramble(sobol_dim0(shuffled), hash_combine(dim_seed, 0)));
+    return wrap(value + mask_offset(dimension++));
+}
+
+Sample2D BlueNoiseSampler::get_2d() {
+    uint32_t dim_seed = hash_combine(seed, dimension);
+    uint32_t shuffled = nested_uniform_scramble(index, dim_seed);
+    float u = to_unit_float(nested_uniform_scramble(sobol_dim0(shuffled), hash_combine(dim_seed, 0)));
+    float v = to_unit_float(nested_uniform_scramble(sobol_dim1(shuffled), hash_combine(dim_seed, 1)));
+    Sample2D sample = {wrap(u + mask_offset(dimension)), wrap(v + mask_offset(dimension + 1))};
+    dimension += 2;
+    return sample;
+}
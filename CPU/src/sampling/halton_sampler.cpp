@@ -0,0 +1,54 @@
+#include "sampling/halton_sampler.h"
+#include "sampling/sample_math.h"
+
+namespace {
+
+const uint32_t PRIMES[] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53,
+    59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131
+};
+const uint32_t PRIME_COUNT = sizeof(PRIMES) / sizeof(PRIMES[0]);
+
+float radical_inverse(uint32_t base, uint32_t index) {
+    float inv_base = 1.0f / base;
+    float inv_base_n = 1.0f;
+    uint32_t reversed = 0;
+    while (index) {
+        uint32_t next = index / base;
+        uint32_t digit = index - next * base;
+        reversed = reversed * base + digit;
+        inv_base_n *= inv_base;
+        index = next;
+    }
+    return clamp_unit(reversed * inv_base_n);
+}
+
+}
+
+HaltonSampler::HaltonSampler(uint32_t seed) : seed(seed), pixel_seed(0), index(0), dimension(0) {}
+
+void HaltonSampler::start_pixel_sample(int x, int y, int sample_index) {
+    pixel_seed = hash_combine(hash_combine(seed, x), y);
+    index = sample_index;
+    dimension = 0;
+}
+
+float HaltonSampler::sample_dimension(uint32_t dim) const {
+    uint32_t dim_seed = hash_combine(pixel_seed, dim);
+    if (dim >= PRIME_COUNT) {
+        return to_unit_float(hash_combine(dim_seed, index));
+    }
+    
+    float value = radical_inverse(PRIMES[dim], index) + to_unit_float(dim_seed);
+    return clamp_unit(value >= 1.0f ? value - 1.0f : value);
+}
+
+float HaltonSampler::get_1d() {
+    return sample_dimension(dimension++);
+}
+
+Sample2D HaltonSampler::get_2d() {
+    Sample2D sample = {sample_dimension(dimension), sample_dimension(dimension + 1)};
+    dimension += 2;
+    return sample;
+}
@@ -0,0 +1,20 @@
+#include "sampling/independent_sampler.h"
+#include "sampling/sample_math.h"
+
+IndependentSampler::IndependentSampler(uint32_t seed) : seed(seed), pixel_seed(0), index(0), dimension(0) {}
+
+void IndependentSampler::start_pixel_sample(int x, int y, int sample_index) {
+    pixel_seed = hash_combine(hash_combine(seed, x), y);
+    index = sample_index;
+    dimension = 0;
+}
+
+float IndependentSampler::get_1d() {
+    return to_unit_float(hash_combine(hash_combine(pixel_seed, dimension++), index));
+}
+
+Sample2D IndependentSampler::get_2d() {
+    float u = get_1d();
+    float v = get_1d();
+    return {u, v};
+}
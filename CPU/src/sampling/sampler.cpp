@@ -0,0 +1,47 @@
+#include "sampling/sampler.h"
+#include "sampling/independent_sampler.h"
+#include "sampling/stratified_sampler.h"
+#include "sampling/halton_sampler.h"
+#include "sampling/sobol_sampler.h"
+#include "sampling/blue_noise_sampler.h"
+
+std::unique_ptr<Sampler> make_sampler(SamplerType type, int samples_per_pixel, uint32_t seed) {
+    switch (type) {
+        case SamplerType::Stratified:
+            return std::make_unique<StratifiedSampler>(samples_per_pixel, seed);
+        case SamplerType::Halton:
+            return std::make_unique<HaltonSampler>(seed);
+        case SamplerType::Sobol:
+            return std::make_unique<SobolSampler>(seed);
+        case SamplerType::BlueNoise:
+            return std::make_unique<BlueNoiseSampler>(seed);
+        case SamplerType::Independent:
+        default:
+            return std::make_unique<IndependentSampler>(seed);
+    }
+}
+
+const char* sampler_name(SamplerType type) {
+    switch (type) {
+        case SamplerType::Stratified: return "stratified";
+        case SamplerType::Halton: return "halton";
+        case SamplerType::Sobol: return "sobol";
+        case SamplerType::BlueNoise: return "bluenoise";
+        case SamplerType::Independent:
+        default: return "independent";
+    }
+}
+
+bool parse_sampler_type(const std::string& name, SamplerType& type) {
+    const SamplerType all[] = {
+        SamplerType::Independent, SamplerType::Stratified, SamplerType::Halton,
+        SamplerType::Sobol, SamplerType::BlueNoise
+    };
+    for (SamplerType candidate : all) {
+        if (name == sampler_name(candidate)) {
+            type = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,26 @@
+#include "sampling/sobol_sampler.h"
+#include "sampling/sample_math.h"
+
+SobolSampler::SobolSampler(uint32_t seed) : seed(seed), pixel_seed(0), index(0), dimension(0) {}
+
+void SobolSampler::start_pixel_sample(int x, int y, int sample_index) {
+    pixel_seed = hash_combine(hash_combine(seed, x), y);
+    index = sample_index;
+    dimension = 0;
+}
+
+float SobolSampler::get_1d() {
+    uint32_t dim_seed = hash_combine(pixel_seed, dimension++);
+    uint32_t shuffled = nested_uniform_scramble(index, dim_seed);
+    return to_unit_float(nested_uniform_scramble(sobol_dim0(shuffled), hash_combine(dim_seed, 0)));
+}
+
+Sample2D SobolSampler::get_2d() {
+    uint32_t dim_seed = hash_combine(pixel_seed, dimension);
+    dimension += 2;
+    uint32_t shuffled = nested_uniform_scramble(index, dim_seed);
+    return {
+        to_unit_float(nested_uniform_scramble(sobol_dim0(shuffled), hash_combine(dim_seed, 0))),
+        to_unit_float(nested_uniform_scramble(sobol_dim1(shuffled), hash_combine(dim_seed, 1)))
+    };
+}
@@ -0,0 +1,42 @@
+#include "sampling/stratified_sampler.h"
+#include "sampling/sample_math.h"
+#include <cmath>
+
+StratifiedSampler::StratifiedSampler(int samples_per_pixel, uint32_t seed)
+    : samples_per_pixel(samples_per_pixel), seed(seed), pixel_seed(0), index(0), dimension(0) {
+    strata_x = static_cast<uint32_t>(std::sqrt(static_cast<float>(samples_per_pixel)));
+    if (strata_x == 0) strata_x = 1;
+    strata_y = samples_per_pixel / strata_x;
+}
+
+void StratifiedSampler::start_pixel_sample(int x, int y, int sample_index) {
+    pixel_seed = hash_combine(hash_combine(seed, x), y);
+    index = sample_index;
+    dimension = 0;
+}
+
+float StratifiedSampler::get_1d() {
+    uint32_t dim_seed = hash_combine(pixel_seed, dimension++);
+    float jitter = to_unit_float(hash_combine(dim_seed, index));
+    
+    if (index >= samples_per_pixel) return jitter;
+    uint32_t stratum = permute_index(index, samples_per_pixel, dim_seed);
+    return clamp_unit((stratum + jitter) / samples_per_pixel);
+}
+
+Sample2D StratifiedSampler::get_2d() {
+    uint32_t dim_seed = hash_combine(pixel_seed, dimension);
+    dimension += 2;
+    float jitter_u = to_unit_float(hash_combine(dim_seed, 2 * index));
+    float jitter_v = to_unit_float(hash_combine(dim_seed, 2 * index + 1));
+    
+    // Samples beyond the last full grid row fall back to plain random values
+    uint32_t strata = strata_x * strata_y;
+    if (index >= strata) return {jitter_u, jitter_v};
+    
+    uint32_t stratum = permute_index(index, strata, dim_seed);
+    return {
+        clamp_unit((stratum % strata_x + jitter_u) / strata_x),
+        clamp_unit((stratum / strata_x + jitter_v) / strata_y)
+    };
+}
@@ -1,15 +1,17 @@
 #include "scenes/complex_scene.h"
+#include "core/scene_arena.h"
+#include "geometry/plane.h"
 #include "geometry/sphere.h"
 #include "materials/lambertian.h"
 #include <random>
 #include <cmath>
 
-std::vector<std::shared_ptr<Hittable>> ComplexScene::create_objects() {
+std::vector<std::shared_ptr<Hittable>> ComplexScene::create_objects(SceneArena& arena) {
     std::vector<std::shared_ptr<Hittable>> objects;
     
     // Ground
-    auto ground_material = std::make_shared<Lambertian>(Color(0.5f, 0.5f, 0.5f));
-    objects.push_back(std::make_shared<Sphere>(Point3(0, -1000, 0), 1000, ground_material));
+    auto ground_material = arena.make<Lambertian>(Color(0.5f, 0.5f, 0.5f));
+    objects.push_back(arena.make<Plane>(Point3(0, 0, 0), Vec3(0, 1, 0), ground_material));
     
     // Random number generation
     std::random_device rd;
@@ -28,27 +30,27 @@ std::vector<std::shared_ptr<Hittable>> ComplexScene::create_objects() {
                 if (choose_mat < 0.8f) {
                     // Diffuse material with random color
                     Color albedo = random_color();
-                    sphere_material = std::make_shared<Lambertian>(albedo);
+                    sphere_material = arena.make<Lambertian>(albedo);
                 } else {
                     // Darker materials
                     Color albedo = random_color() * 0.5f;
-                    sphere_material = std::make_shared<Lambertian>(albedo);
+                    sphere_material = arena.make<Lambertian>(albedo);
                 }
                 
-                objects.push_back(std::make_shared<Sphere>(center, 0.2f, sphere_material));
+                objects.push_back(arena.make<Sphere>(center, 0.2f, sphere_material));
             }
         }
     }
     
     // Three larger spheres
-    auto material1 = std::make_shared<Lambertian>(Color(0.4f, 0.2f, 0.1f));
-    objects.push_back(std::make_shared<Sphere>(Point3(-4, 1, 0), 1.0f, material1));
+    auto material1 = arena.make<Lambertian>(Color(0.4f, 0.2f, 0.1f));
+    objects.push_back(arena.make<Sphere>(Point3(-4, 1, 0), 1.0f, material1));
     
-    auto material2 = std::make_shared<Lambertian>(Color(0.7f, 0.6f, 0.5f));
-    objects.push_back(std::make_shared<Sphere>(Point3(0, 1, 0), 1.0f, material2));
+    auto material2 = arena.make<Lambertian>(Color(0.7f, 0.6f, 0.5f));
+    objects.push_back(arena.make<Sphere>(Point3(0, 1, 0), 1.0f, material2));
     
-    auto material3 = std::make_shared<Lambertian>(Color(0.7f, 0.3f, 0.3f));
-    objects.push_back(std::make_shared<Sphere>(Point3(4, 1, 0), 1.0f, material3));
+    auto material3 = arena.make<Lambertian>(Color(0.7f, 0.3f, 0.3f));
+    objects.push_back(arena.make<Sphere>(Point3(4, 1, 0), 1.0f, material3));
     
     return objects;
 }
@@ -0,0 +1,56 @@
+#include "scenes/field_scene.h"
+#include "core/scene_arena.h"
+#include "geometry/plane.h"
+#include "geometry/sphere.h"
+#include "materials/lambertian.h"
+#include <random>
+
+std::vector<std::shared_ptr<Hittable>> FieldScene::create_objects(SceneArena& arena) {
+    std::vector<std::shared_ptr<Hittable>> objects;
+    objects.reserve(GRID_SIZE * GRID_SIZE + 1);
+    
+    auto ground_material = arena.make<Lambertian>(Color(0.5f, 0.5f, 0.5f));
+    objects.push_back(arena.make<Plane>(Point3(0, 0, 0), Vec3(0, 1, 0), ground_material));
+    
+    // A small palette keeps a million spheres from needing a million materials
+    const int palette_size = 16;
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    std::shared_ptr<Lambertian> palette[palette_size];
+    for (int i = 0; i < palette_size; i++) {
+        palette[i] = arena.make<Lambertian>(Color(0.2f + 0.7f * dis(gen), 0.2f + 0.7f * dis(gen), 0.2f + 0.7f * dis(gen)));
+    }
+    
+    // One sphere per unit cell, jittered and resting on the ground
+    const float half = GRID_SIZE * 0.5f;
+    for (int a = 0; a < GRID_SIZE; a++) {
+        for (int b = 0; b < GRID_SIZE; b++) {
+            float radius = 0.1f + 0.25f * dis(gen);
+            Point3 center(a - half + 0.5f + 0.3f * (dis(gen) - 0.5f), radius,
+                          b - half + 0.5f + 0.3f * (dis(gen) - 0.5f));
+            objects.push_back(arena.make<Sphere>(center, radius, palette[gen() % palette_size]));
+        }
+    }
+    
+    return objects;
+}
+
+SceneConfig FieldScene::get_config() {
+    SceneConfig config;
+    config.aspect_ratio = 16.0f / 9.0f;
+    config.image_width = 400;
+    config.samples_per_pixel = 16;
+    config.max_depth = 8;
+    
+    // Low over one corner, looking across the field so rays pass many cells
+    config.camera_pos = Point3(-500.0f, 6.0f, -500.0f);
+    config.camera_target = Point3(-480.0f, 0.0f, -470.0f);
+    config.camera_up = Vec3(0, 1, 0);
+    config.camera_fov = 50.0f;
+    
+    return config;
+}
+
+const char* FieldScene::get_name() {
+    return "Field Scene (1M+ spheres)";
+}
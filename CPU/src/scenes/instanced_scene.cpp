@@ -0,0 +1,81 @@
+#include "scenes/instanced_scene.h"
+#include "core/scene_arena.h"
+#include "geometry/plane.h"
+#include "geometry/sphere.h"
+#include "geometry/instance.h"
+#include "materials/lambertian.h"
+#include "core/kdtree.h"
+#include <random>
+#include <cmath>
+
+std::vector<std::shared_ptr<Hittable>> InstancedScene::create_objects(SceneArena& arena) {
+    std::vector<std::shared_ptr<Hittable>> objects;
+    
+    // Ground
+    auto ground_material = arena.make<Lambertian>(Color(0.5f, 0.5f, 0.5f));
+    objects.push_back(arena.make<Plane>(Point3(0, 0, 0), Vec3(0, 1, 0), ground_material));
+    
+    // One bottom-level tree shared by every instance
+    auto cluster = create_cluster(arena);
+    
+    std::mt19937 gen(42); // Fixed seed for reproducible results
+    std::uniform_real_distribution<float> dis(0.0f, 1.0f);
+    
+    // 32x32 grid of randomly rotated and scaled copies
+    for (int a = -16; a < 16; a++) {
+        for (int b = -16; b < 16; b++) {
+            float s = 0.15f + 0.1f * dis(gen);
+            Point3 position(a * 0.7f + 0.3f * dis(gen), 0.0f, b * 0.7f + 0.3f * dis(gen));
+            
+            Transform object_to_world = Transform::translate(position)
+                                      * Transform::rotate_y(360.0f * dis(gen))
+                                      * Transform::scale(s);
+            objects.push_back(arena.make<Instance>(cluster, object_to_world));
+        }
+    }
+    
+    return objects;
+}
+
+std::shared_ptr<Hittable> InstancedScene::create_cluster(SceneArena& arena) const {
+    std::vector<std::shared_ptr<Hittable>> spheres;
+    
+    // A center sphere ringed by six smaller ones, resting on y=0
+    auto center_material = arena.make<Lambertian>(Color(0.7f, 0.3f, 0.3f));
+    spheres.push_back(arena.make<Sphere>(Point3(0, 1.0f, 0), 1.0f, center_material));
+    
+    for (int k = 0; k < 6; k++) {
+        float angle = k * M_PI / 3.0f;
+        Color albedo(0.2f + 0.1f * k, 0.5f, 0.8f - 0.1f * k);
+        spheres.push_back(arena.make<Sphere>(
+            Point3(1.4f * cos(angle), 0.4f, 1.4f * sin(angle)), 0.4f,
+            arena.make<Lambertian>(albedo)));
+    }
+    
+    // Small sphere on top
+    auto top_material = arena.make<Lambertian>(Color(0.9f, 0.8f, 0.2f));
+    spheres.push_back(arena.make<Sphere>(Point3(0, 2.25f, 0), 0.25f, top_material));
+    
+    auto cluster = arena.make<KDTree>();
+    cluster->build(spheres, &arena);
+    return cluster;
+}
+
+SceneConfig InstancedScene::get_config() {
+    SceneConfig config;
+    config.aspect_ratio = 3.0f / 2.0f;
+    config.image_width = 600;
+    config.samples_per_pixel = 50;
+    config.max_depth = 50;
+    
+    config.camera_pos = Point3(16, 5, 10);
+    config.camera_target = Point3(0, 0, 0);
+    config.camera_up = Vec3(0, 1, 0);
+    config.camera_fov = 35.0f;
+    
+    return config;
+}
+
+const char* InstancedScene::get_name() {
+    return "Instanced Scene (1024 instances of an 8-sphere cluster)";
+}
@@ -0,0 +1,61 @@
+#include "scenes/lights_scene.h"
+#include "core/scene_arena.h"
+#include "geometry/sphere.h"
+#include "materials/lambertian.h"
+#include "materials/diffuse_light.h"
+
+std::vector<std::shared_ptr<Hittable>> LightsScene::create_objects(SceneArena& arena) {
+    std::vector<std::shared_ptr<Hittable>> objects;
+    
+    // Room: floor, ceiling and walls are huge spheres, so they are nearly flat
+    auto white = arena.make<Lambertian>(Color(0.73f, 0.73f, 0.73f));
+    auto red = arena.make<Lambertian>(Color(0.65f, 0.05f, 0.05f));
+    auto green = arena.make<Lambertian>(Color(0.12f, 0.45f, 0.15f));
+    const float big = 1000.0f;
+    
+    objects.push_back(arena.make<Sphere>(Point3(0, -big, 0), big, white));            // Floor, y = 0
+    objects.push_back(arena.make<Sphere>(Point3(0, big + 4.0f, 0), big, white));      // Ceiling, y = 4
+    objects.push_back(arena.make<Sphere>(Point3(0, 0, -big - 3.0f), big, white));     // Back wall, z = -3
+    objects.push_back(arena.make<Sphere>(Point3(0, 0, big + 7.0f), big, white));      // Front wall, z = 7
+    objects.push_back(arena.make<Sphere>(Point3(-big - 3.0f, 0, 0), big, red));       // Left wall, x = -3
+    objects.push_back(arena.make<Sphere>(Point3(big + 3.0f, 0, 0), big, green));      // Right wall, x = 3
+    
+    // Furniture
+    objects.push_back(arena.make<Sphere>(Point3(-1.2f, 0.8f, -0.8f), 0.8f,
+        arena.make<Lambertian>(Color(0.8f, 0.6f, 0.2f))));
+    objects.push_back(arena.make<Sphere>(Point3(1.1f, 0.6f, -0.2f), 0.6f,
+        arena.make<Lambertian>(Color(0.2f, 0.4f, 0.8f))));
+    objects.push_back(arena.make<Sphere>(Point3(0.1f, 0.35f, 0.9f), 0.35f, white));
+    
+    // Small emitters
+    objects.push_back(arena.make<Sphere>(Point3(0, 3.6f, -0.5f), 0.15f,
+        arena.make<DiffuseLight>(Color(60.0f, 55.0f, 45.0f))));
+    objects.push_back(arena.make<Sphere>(Point3(-2.4f, 2.0f, -2.4f), 0.08f,
+        arena.make<DiffuseLight>(Color(80.0f, 20.0f, 10.0f))));
+    objects.push_back(arena.make<Sphere>(Point3(2.2f, 0.3f, 1.5f), 0.1f,
+        arena.make<DiffuseLight>(Color(10.0f, 30.0f, 80.0f))));
+    
+    return objects;
+}
+
+SceneConfig LightsScene::get_config() {
+    SceneConfig config;
+    config.aspect_ratio = 3.0f / 2.0f;
+    config.image_width = 450;
+    config.samples_per_pixel = 64;
+    config.max_depth = 8;
+    
+    config.camera_pos = Point3(0, 2.0f, 6.0f);
+    config.camera_target = Point3(0, 1.2f, 0);
+    config.camera_up = Vec3(0, 1, 0);
+    config.camera_fov = 60.0f;
+    
+    config.sky = false;
+    config.background = Color(0, 0, 0);
+    
+    return config;
+}
+
+const char* LightsScene::get_name() {
+    return "Lights Scene (room lit by 3 small emitters)";
+}
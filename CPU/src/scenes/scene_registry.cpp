@@ -0,0 +1,25 @@
+#include "scenes/scene_registry.h"
+#include "scenes/simple_scene.h"
+#include "scenes/complex_scene.h"
+#include "scenes/instanced_scene.h"
+#include "scenes/lights_scene.h"
+#include "scenes/field_scene.h"
+
+std::unique_ptr<Scene> create_scene(const std::string& name) {
+    if (name == "simple") {
+        return std::make_unique<SimpleScene>();
+    } else if (name == "complex") {
+        return std::make_unique<ComplexScene>();
+    } else if (name == "instanced") {
+        return std::make_unique<InstancedScene>();
+    } else if (name == "lights") {
+        return std::make_unique<LightsScene>();
+    } else if (name == "field") {
+        return std::make_unique<FieldScene>();
+    }
+    return nullptr;
+}
+
+const char* scene_names() {
+    return "simple complex instanced lights field";
+}
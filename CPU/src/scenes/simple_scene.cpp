@@ -1,21 +1,22 @@
 #include "scenes/simple_scene.h"
+#include "core/scene_arena.h"
 #include "geometry/sphere.h"
 #include "materials/lambertian.h"
 
-std::vector<std::shared_ptr<Hittable>> SimpleScene::create_objects() {
+std::vector<std::shared_ptr<Hittable>> SimpleScene::create_objects(SceneArena& arena) {
     std::vector<std::shared_ptr<Hittable>> objects;
     
     // Materials
-    auto material_ground = std::make_shared<Lambertian>(Color(0.8f, 0.8f, 0.0f));
-    auto material_center = std::make_shared<Lambertian>(Color(0.7f, 0.3f, 0.3f));
-    auto material_left = std::make_shared<Lambertian>(Color(0.0f, 0.0f, 1.0f));
-    auto material_right = std::make_shared<Lambertian>(Color(0.8f, 0.6f, 0.2f));
+    auto material_ground = arena.make<Lambertian>(Color(0.8f, 0.8f, 0.0f));
+    auto material_center = arena.make<Lambertian>(Color(0.7f, 0.3f, 0.3f));
+    auto material_left = arena.make<Lambertian>(Color(0.0f, 0.0f, 1.0f));
+    auto material_right = arena.make<Lambertian>(Color(0.8f, 0.6f, 0.2f));
     
     // Objects
-    objects.push_back(std::make_shared<Sphere>(Point3(0.0f, -100.5f, -1.0f), 100.0f, material_ground));
-    objects.push_back(std::make_shared<Sphere>(Point3(0.0f, 0.0f, -1.0f), 0.5f, material_center));
-    objects.push_back(std::make_shared<Sphere>(Point3(-1.0f, 0.0f, -1.0f), 0.5f, material_left));
-    objects.push_back(std::make_shared<Sphere>(Point3(1.0f, 0.0f, -1.0f), 0.5f, material_right));
+    objects.push_back(arena.make<Sphere>(Point3(0.0f, -100.5f, -1.0f), 100.0f, material_ground));
+    objects.push_back(arena.make<Sphere>(Point3(0.0f, 0.0f, -1.0f), 0.5f, material_center));
+    objects.push_back(arena.make<Sphere>(Point3(-1.0f, 0.0f, -1.0f), 0.5f, material_left));
+    objects.push_back(arena.make<Sphere>(Point3(1.0f, 0.0f, -1.0f), 0.5f, material_right));
     
     return objects;
 }
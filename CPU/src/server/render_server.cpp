@@ -0,0 +1,447 @@
+#include "server/render_server.h"
+#include "simd/kernels.h"
+#include "utils/trace.h"
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// One client: requests are read from in_fd, responses written to out_fd
+struct RenderServer::Connection {
+    int in_fd;
+    int out_fd;
+    bool owns_fds;
+    std::atomic<bool> finished;  // Reader thread has seen the end of input
+    std::mutex write_mutex;  // Responses from the dispatcher and stats replies may interleave
+    
+    Connection(int in_fd, int out_fd, bool owns_fds)
+        : in_fd(in_fd), out_fd(out_fd), owns_fds(owns_fds), finished(false) {}
+    
+    ~Connection() {
+        if (owns_fds) {
+            close(in_fd);
+        }
+    }
+    
+    // Write a header and optional payload atomically with respect to other responses
+    void send(const std::string& header, const void* payload = nullptr, size_t payload_size = 0) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        write_all(header.data(), header.size());
+        if (payload_size > 0) {
+            write_all(payload, payload_size);
+        }
+    }
+
+private:
+    void write_all(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = write(out_fd, bytes, size);
+            if (written <= 0) return;  // Client went away; nothing useful left to do
+            bytes += written;
+            size -= written;
+        }
+    }
+};
+
+namespace {
+
+// Largest image a job may ask for, so one request cannot exhaust memory
+const long long MAX_JOB_PIXELS = 64LL * 1024 * 1024;
+
+// Whole-string integer parse; atoi would turn "abc" into 0
+bool parse_int(const std::string& text, int& value) {
+    if (text.empty()) return false;
+    char* end;
+    errno = 0;
+    long parsed = std::strtol(text.c_str(), &end, 10);
+    if (*end != '\0' || errno == ERANGE || parsed < INT_MIN || parsed > INT_MAX) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// Read one '\n'-terminated line from fd; returns false at end of input
+bool read_line(int fd, std::string& buffer, std::string& line) {
+    while (true) {
+        size_t newline = buffer.find('\n');
+        if (newline != std::string::npos) {
+            line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            return true;
+        }
+        
+        char chunk[4096];
+        ssize_t received = read(fd, chunk, sizeof(chunk));
+        if (received <= 0) {
+            if (buffer.empty()) return false;
+            line.swap(buffer);
+            buffer.clear();
+            return true;
+        }
+        buffer.append(chunk, received);
+    }
+}
+
+double milliseconds_between(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+}
+
+RenderServer::RenderServer(const RenderOptions& options, size_t cache_capacity)
+    : options(options), pool(0, options.thread_placement()), cache(cache_capacity),
+      next_sequence(0), accepting(true),
+      jobs_completed(0), jobs_failed(0), max_queue_depth(0),
+      total_latency_ms(0.0), max_latency_ms(0.0) {}
+
+RenderServer::~RenderServer() = default;
+
+void RenderServer::serve_stdio() {
+    std::cerr << "Render server reading jobs from stdin (" << pool.size() << " threads)\n";
+    
+    std::thread dispatcher(&RenderServer::dispatch_jobs, this);
+    handle_connection(std::make_shared<Connection>(STDIN_FILENO, STDOUT_FILENO, false));
+    
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        accepting = false;
+    }
+    queue_changed.notify_all();
+    dispatcher.join();
+    
+    std::cerr << stats();
+}
+
+void RenderServer::serve_socket(const std::string& path) {
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        throw std::runtime_error("Cannot create socket");
+    }
+    
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        close(listen_fd);
+        throw std::runtime_error("Socket path too long: " + path);
+    }
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(path.c_str());
+    
+    if (bind(listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listen_fd, 16) < 0) {
+        close(listen_fd);
+        throw std::runtime_error("Cannot listen on socket: " + path);
+    }
+    
+    std::cerr << "Render server listening on " << path << " (" << pool.size() << " threads)\n";
+    
+    std::thread dispatcher(&RenderServer::dispatch_jobs, this);
+    
+    // A shutdown request closes listen_fd from its connection thread, which ends accept()
+    std::thread acceptor([this, listen_fd] {
+        while (true) {
+            int client_fd = accept(listen_fd, nullptr, nullptr);
+            if (client_fd < 0) break;
+            auto connection = std::make_shared<Connection>(client_fd, client_fd, true);
+            join_finished_connections();
+            std::lock_guard<std::mutex> lock(connections_mutex);
+            connection_threads.push_back({connection, std::thread(&RenderServer::handle_connection, this, connection)});
+        }
+    });
+    
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        queue_changed.wait(lock, [this] { return !accepting; });
+    }
+    shutdown(listen_fd, SHUT_RDWR);
+    close(listen_fd);
+    acceptor.join();
+    dispatcher.join();
+    
+    // Every queued job has been answered; end the clients' reads and wait for their threads
+    {
+        std::lock_guard<std::mutex> lock(connections_mutex);
+        for (auto& entry : connection_threads) {
+            shutdown(entry.connection->in_fd, SHUT_RDWR);
+        }
+        for (auto& entry : connection_threads) {
+            entry.thread.join();
+        }
+        connection_threads.clear();
+    }
+    unlink(path.c_str());
+    
+    std::cerr << stats();
+}
+
+void RenderServer::handle_connection(std::shared_ptr<Connection> connection) {
+    std::string buffer;
+    std::string line;
+    while (read_line(connection->in_fd, buffer, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        handle_request(line, connection);
+    }
+    connection->finished = true;
+}
+
+void RenderServer::join_finished_connections() {
+    std::lock_guard<std::mutex> lock(connections_mutex);
+    for (auto entry = connection_threads.begin(); entry != connection_threads.end();) {
+        if (entry->connection->finished) {
+            entry->thread.join();
+            entry = connection_threads.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+}
+
+void RenderServer::handle_request(const std::string& line, const std::shared_ptr<Connection>& connection) {
+    std::istringstream fields(line);
+    std::string command;
+    fields >> command;
+    
+    if (command == "render") {
+        Job job;
+        std::string error;
+        if (!parse_job(line, job, error)) {
+            connection->send("error " + (job.id.empty() ? std::string("-") : job.id) + " " + error + "\n");
+            return;
+        }
+        job.connection = connection;
+        submit(std::move(job));
+    } else if (command == "stats") {
+        connection->send(stats());
+    } else if (command == "shutdown") {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex);
+            accepting = false;
+        }
+        queue_changed.notify_all();
+    } else {
+        connection->send("error - unknown command: " + command + "\n");
+    }
+}
+
+bool RenderServer::parse_job(const std::string& line, Job& job, std::string& error) const {
+    std::istringstream fields(line);
+    std::string token;
+    fields >> token;  // "render"
+    
+    while (fields >> token) {
+        size_t equals = token.find('=');
+        if (equals == std::string::npos) {
+            error = "expected key=value: " + token;
+            return false;
+        }
+        std::string key = token.substr(0, equals);
+        std::string value = token.substr(equals + 1);
+        
+        if (key == "id") {
+            job.id = value;
+        } else if (key == "scene") {
+            job.scene = value;
+        } else if (key == "width") {
+            if (!parse_int(value, job.width) || job.width < 2) {
+                error = "width must be an integer of at least 2: " + value;
+                return false;
+            }
+        } else if (key == "spp") {
+            if (!parse_int(value, job.samples_per_pixel) || job.samples_per_pixel <= 0) {
+                error = "spp must be a positive integer: " + value;
+                return false;
+            }
+        } else if (key == "priority") {
+            if (!parse_int(value, job.priority)) {
+                error = "priority must be an integer: " + value;
+                return false;
+            }
+        } else if (key == "format") {
+            if (value != "rgb8" && value != "float") {
+                error = "unknown format: " + value;
+                return false;
+            }
+            job.float_output = (value == "float");
+        } else if (key == "camera") {
+            int consumed = 0;
+            if (sscanf(value.c_str(), "%f,%f,%f,%f,%f,%f,%f%n",
+                       &job.camera_pos.x, &job.camera_pos.y, &job.camera_pos.z,
+                       &job.camera_target.x, &job.camera_target.y, &job.camera_target.z,
+                       &job.camera_fov, &consumed) != 7 || value[consumed] != '\0') {
+                error = "camera needs px,py,pz,tx,ty,tz,fov";
+                return false;
+            }
+            if (!(job.camera_fov > 0.0f && job.camera_fov < 180.0f)) {
+                error = "camera fov must be in (0, 180)";
+                return false;
+            }
+            job.has_camera = true;
+        } else {
+            error = "unknown key: " + key;
+            return false;
+        }
+    }
+    
+    if (job.id.empty()) job.id = "-";
+    if (job.scene.empty()) {
+        error = "missing scene";
+        return false;
+    }
+    return true;
+}
+
+void RenderServer::submit(Job job) {
+    size_t depth;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        if (!accepting) {
+            // The dispatcher may already have drained the queue and stopped
+            job.connection->send("error " + job.id + " server shutting down\n");
+            jobs_failed++;
+            return;
+        }
+        job.submitted = Clock::now();
+        job.sequence = next_sequence++;
+        queue.push(std::move(job));
+        depth = queue.size();
+        max_queue_depth = std::max(max_queue_depth, depth);
+    }
+    queue_changed.notify_all();
+    std::cerr << "Queued job, queue depth " << depth << "\n";
+}
+
+void RenderServer::dispatch_jobs() {
+    Tracer::set_thread_name("dispatcher");
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_changed.wait(lock, [this] { return !queue.empty() || !accepting; });
+            if (queue.empty()) return;  // Drained after shutdown
+            job = queue.top();
+            queue.pop();
+        }
+        run_job(job);
+    }
+}
+
+void RenderServer::run_job(const Job& job) {
+    // A failing job is answered and counted; it must not stop the dispatcher
+    try {
+        execute_job(job);
+    } catch (const std::exception& e) {
+        job.connection->send("error " + job.id + " " + e.what() + "\n");
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        jobs_failed++;
+    }
+}
+
+void RenderServer::execute_job(const Job& job) {
+    TraceScope trace("job", "server");
+    auto start = Clock::now();
+    double queue_ms = milliseconds_between(job.submitted, start);
+    
+    std::shared_ptr<const CachedScene> scene;
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+        scene = cache.get(job.scene, options.accelerator, options.numa_replicate ? &pool : nullptr);
+    }
+    if (!scene) {
+        throw std::runtime_error("unknown scene: " + job.scene);
+    }
+    
+    SceneConfig config = scene->config;
+    options.apply(config);
+    if (job.width > 0) config.image_width = job.width;
+    if (job.samples_per_pixel > 0) config.samples_per_pixel = job.samples_per_pixel;
+    if (job.has_camera) {
+        config.camera_pos = job.camera_pos;
+        config.camera_target = job.camera_target;
+        config.camera_fov = job.camera_fov;
+    }
+    int width = config.image_width;
+    int height = config.get_image_height();
+    if (width < 2 || height < 2) {
+        throw std::runtime_error("image must be at least 2x2 pixels, got " +
+                                 std::to_string(width) + "x" + std::to_string(height));
+    }
+    if (static_cast<long long>(width) * height > MAX_JOB_PIXELS) {
+        throw std::runtime_error("image exceeds " + std::to_string(MAX_JOB_PIXELS) + " pixels");
+    }
+    
+    Camera cam(config.camera_pos, config.camera_target, config.camera_up,
+               config.camera_fov, config.aspect_ratio);
+    Framebuffer framebuffer(width, height);
+    Renderer::render_frame(scene->world, cam, config, options, pool, framebuffer);
+    
+    // Convert to the requested binary layout
+    std::vector<unsigned char> payload;
+    if (job.float_output) {
+        std::vector<float> values(framebuffer.pixels.size() * 3);
+        float scale = 1.0f / config.samples_per_pixel;
+        for (size_t i = 0; i < framebuffer.pixels.size(); i++) {
+            values[3 * i] = framebuffer.pixels[i].x * scale;
+            values[3 * i + 1] = framebuffer.pixels[i].y * scale;
+            values[3 * i + 2] = framebuffer.pixels[i].z * scale;
+        }
+        payload.resize(values.size() * sizeof(float));
+        memcpy(payload.data(), values.data(), payload.size());
+    } else {
+        payload.resize(framebuffer.pixels.size() * 3);
+        simd_kernels().tonemap_rgb8(&framebuffer.pixels[0].x, payload.size(),
+                                    1.0f / config.samples_per_pixel, payload.data());
+    }
+    
+    auto end = Clock::now();
+    double render_ms = milliseconds_between(start, end);
+    double latency_ms = milliseconds_between(job.submitted, end);
+    
+    char header[256];
+    snprintf(header, sizeof(header), "result %s %d %d %s %zu %.3f %.3f\n",
+             job.id.c_str(), width, height, job.float_output ? "float" : "rgb8",
+             payload.size(), queue_ms, render_ms);
+    job.connection->send(header, payload.data(), payload.size());
+    
+    size_t depth;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        jobs_completed++;
+        total_latency_ms += latency_ms;
+        max_latency_ms = std::max(max_latency_ms, latency_ms);
+        depth = queue.size();
+    }
+    
+    std::cerr << "Job " << job.id << " (" << job.scene << ", " << width << "x" << height
+              << ", " << config.samples_per_pixel << " spp, priority " << job.priority << "): "
+              << "queued " << queue_ms << " ms, rendered " << render_ms << " ms, "
+              << "latency " << latency_ms << " ms, queue depth " << depth << "\n";
+}
+
+std::string RenderServer::stats() const {
+    std::lock_guard<std::mutex> queue_lock(queue_mutex);
+    std::lock_guard<std::mutex> cache_lock(cache_mutex);
+    
+    std::ostringstream out;
+    out << "stats jobs_completed=" << jobs_completed
+        << " jobs_failed=" << jobs_failed
+        << " queue_depth=" << queue.size()
+        << " max_queue_depth=" << max_queue_depth
+        << " mean_latency_ms=" << (jobs_completed ? total_latency_ms / jobs_completed : 0.0)
+        << " max_latency_ms=" << max_latency_ms
+        << " cached_scenes=" << cache.size()
+        << " cache_hits=" << cache.hits()
+        << " cache_misses=" << cache.misses() << "\n";
+    return out.str();
+}
@@ -0,0 +1,38 @@
+#include "server/scene_cache.h"
+#include "rendering/renderer.h"
+#include "scenes/scene_registry.h"
+
+SceneCache::SceneCache(size_t capacity) : capacity(capacity), hit_count(0), miss_count(0) {}
+
+std::shared_ptr<const CachedScene> SceneCache::get(const std::string& name, AcceleratorType accelerator,
+                                                   const ThreadPool* replicate_for) {
+    std::string key = name + ":" + accelerator_name(accelerator);
+    
+    auto found = index.find(key);
+    if (found != index.end()) {
+        hit_count++;
+        entries.splice(entries.begin(), entries, found->second);
+        return found->second->second;
+    }
+    
+    auto scene = create_scene(name);
+    if (!scene) return nullptr;
+    miss_count++;
+    
+    auto cached = std::make_shared<CachedScene>();
+    cached->name = scene->get_name();
+    cached->config = scene->get_config();
+    cached->world = Renderer::build_world(*scene, accelerator);
+    if (replicate_for) {
+        Renderer::replicate_accelerator(cached->world, accelerator, *replicate_for);
+    }
+    
+    // Jobs still rendering an evicted scene keep it alive through their shared_ptr
+    if (entries.size() >= capacity && !entries.empty()) {
+        index.erase(entries.back().first);
+        entries.pop_back();
+    }
+    entries.emplace_front(key, cached);
+    index[key] = entries.begin();
+    return cached;
+}
@@ -0,0 +1,54 @@
+#include "simd/cpu_features.h"
+
+bool isa_supported(Isa isa) {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::Baseline: return true;
+        case Isa::SSE42: return __builtin_cpu_supports("sse4.2");
+        case Isa::AVX2: return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        case Isa::AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+                   __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq");
+    }
+    return false;
+#else
+    // Only the baseline kernels are built off x86-64
+    return isa == Isa::Baseline;
+#endif
+}
+
+Isa detect_isa() {
+    const Isa levels[] = {Isa::AVX512, Isa::AVX2, Isa::SSE42};
+    for (Isa isa : levels) {
+        if (isa_supported(isa)) {
+            return isa;
+        }
+    }
+    return Isa::Baseline;
+}
+
+const char* isa_name(Isa isa) {
+    switch (isa) {
+        case Isa::Baseline: return "baseline";
+        case Isa::SSE42: return "sse4.2";
+        case Isa::AVX2: return "avx2";
+        case Isa::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool parse_isa(const std::string& name, Isa& isa) {
+    if (name == "baseline" || name == "scalar") {
+        isa = Isa::Baseline;
+    } else if (name == "sse4.2" || name == "sse42") {
+        isa = Isa::SSE42;
+    } else if (name == "avx2") {
+        isa = Isa::AVX2;
+    } else if (name == "avx512") {
+        isa = Isa::AVX512;
+    } else {
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,51 @@
+#include "simd/kernels.h"
+#include "math/ray.h"
+#include <stdexcept>
+#include <string>
+
+namespace kernels_baseline { extern const SimdKernels table; }
+#if defined(__x86_64__)
+namespace kernels_sse42 { extern const SimdKernels table; }
+namespace kernels_avx2 { extern const SimdKernels table; }
+namespace kernels_avx512 { extern const SimdKernels table; }
+#endif
+
+namespace {
+
+const SimdKernels* table_for(Isa isa) {
+#if defined(__x86_64__)
+    switch (isa) {
+        case Isa::AVX512: return &kernels_avx512::table;
+        case Isa::AVX2: return &kernels_avx2::table;
+        case Isa::SSE42: return &kernels_sse42::table;
+        case Isa::Baseline: break;
+    }
+#else
+    (void)isa;
+#endif
+    return &kernels_baseline::table;
+}
+
+// Set by select_isa before first use; otherwise CPUID decides
+bool isa_forced = false;
+Isa forced_isa = Isa::Baseline;
+
+}
+
+KernelRay::KernelRay(const Ray& ray)
+    : origin{ray.origin.x, ray.origin.y, ray.origin.z},
+      direction{ray.direction.x, ray.direction.y, ray.direction.z},
+      inv_direction{1.0f / ray.direction.x, 1.0f / ray.direction.y, 1.0f / ray.direction.z} {}
+
+const SimdKernels& simd_kernels() {
+    static const SimdKernels& kernels = *table_for(isa_forced ? forced_isa : detect_isa());
+    return kernels;
+}
+
+void select_isa(Isa isa) {
+    if (!isa_supported(isa)) {
+        throw std::runtime_error(std::string("This CPU does not support ") + isa_name(isa));
+    }
+    isa_forced = true;
+    forced_isa = isa;
+}
@@ -0,0 +1,16 @@
+#if defined(__x86_64__)
+#define KERNEL_NAMESPACE kernels_avx2
+#include "kernels_impl.h"
+
+namespace kernels_avx2 {
+
+extern const SimdKernels table = {
+    Isa::AVX2,
+    ray_boxes,
+    ray_spheres,
+    accumulate,
+    tonemap_rgb8
+};
+
+}
+#endif
@@ -0,0 +1,14 @@
+#define KERNEL_NAMESPACE kernels_baseline
+#include "kernels_impl.h"
+
+namespace kernels_baseline {
+
+extern const SimdKernels table = {
+    Isa::Baseline,
+    ray_boxes,
+    ray_spheres,
+    accumulate,
+    tonemap_rgb8
+};
+
+}
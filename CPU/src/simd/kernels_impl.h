@@ -0,0 +1,103 @@
+// Kernel bodies, included once per ISA level with KERNEL_NAMESPACE defined.
+// The including file is compiled with that level's -m flags, so this code
+// must not instantiate shared inline functions or templates (std::min,
+// std::vector, ...): the linker could pick this file's copy for callers
+// elsewhere and run wide instructions on a CPU without them. Everything
+// here is static or in KERNEL_NAMESPACE and works on raw arrays.
+#include "simd/kernels.h"
+#include <math.h>
+
+#ifndef KERNEL_NAMESPACE
+#error "Define KERNEL_NAMESPACE before including kernels_impl.h"
+#endif
+
+namespace KERNEL_NAMESPACE {
+
+static inline float min_f(float a, float b) { return a < b ? a : b; }
+static inline float max_f(float a, float b) { return a > b ? a : b; }
+
+// Spheres are tested in chunks so the per-lane pass can use a stack buffer
+static const size_t CHUNK = 64;
+
+static void ray_boxes(const BoxArrays& boxes, size_t count, const KernelRay& ray,
+                      float t_min, float t_max, uint8_t* hits) {
+    const float* __restrict min_x = boxes.bounds[0];
+    const float* __restrict min_y = boxes.bounds[1];
+    const float* __restrict min_z = boxes.bounds[2];
+    const float* __restrict max_x = boxes.bounds[3];
+    const float* __restrict max_y = boxes.bounds[4];
+    const float* __restrict max_z = boxes.bounds[5];
+    const float ox = ray.origin[0], oy = ray.origin[1], oz = ray.origin[2];
+    const float ix = ray.inv_direction[0], iy = ray.inv_direction[1], iz = ray.inv_direction[2];
+    
+    for (size_t i = 0; i < count; i++) {
+        float x0 = (min_x[i] - ox) * ix, x1 = (max_x[i] - ox) * ix;
+        float y0 = (min_y[i] - oy) * iy, y1 = (max_y[i] - oy) * iy;
+        float z0 = (min_z[i] - oz) * iz, z1 = (max_z[i] - oz) * iz;
+        
+        float enter = max_f(max_f(t_min, min_f(x0, x1)), max_f(min_f(y0, y1), min_f(z0, z1)));
+        float exit = min_f(min_f(t_max, max_f(x0, x1)), min_f(max_f(y0, y1), max_f(z0, z1)));
+        hits[i] = exit > enter;
+    }
+}
+
+static int ray_spheres(const SphereArrays& spheres, size_t count, const KernelRay& ray,
+                       float t_min, float t_max, float& t) {
+    const float ox = ray.origin[0], oy = ray.origin[1], oz = ray.origin[2];
+    const float dx = ray.direction[0], dy = ray.direction[1], dz = ray.direction[2];
+    const float a = dx * dx + dy * dy + dz * dz;
+    const float inv_a = 1.0f / a;
+    const float miss = INFINITY;
+    
+    int best = -1;
+    float best_t = t_max;
+    float roots[CHUNK];
+    
+    for (size_t first = 0; first < count; first += CHUNK) {
+        size_t n = count - first < CHUNK ? count - first : CHUNK;
+        const float* __restrict cx = spheres.center_x + first;
+        const float* __restrict cy = spheres.center_y + first;
+        const float* __restrict cz = spheres.center_z + first;
+        const float* __restrict r = spheres.radius + first;
+        
+        // Branch-free per lane: nearest root in range, or infinity
+        for (size_t i = 0; i < n; i++) {
+            float ocx = ox - cx[i], ocy = oy - cy[i], ocz = oz - cz[i];
+            float half_b = ocx * dx + ocy * dy + ocz * dz;
+            float c = ocx * ocx + ocy * ocy + ocz * ocz - r[i] * r[i];
+            float discriminant = half_b * half_b - a * c;
+            float sqrtd = sqrtf(max_f(discriminant, 0.0f));
+            float near_root = (-half_b - sqrtd) * inv_a;
+            float far_root = (-half_b + sqrtd) * inv_a;
+            float root = (near_root >= t_min && near_root <= t_max) ? near_root
+                       : ((far_root >= t_min && far_root <= t_max) ? far_root : miss);
+            roots[i] = discriminant >= 0.0f ? root : miss;
+        }
+        
+        for (size_t i = 0; i < n; i++) {
+            if (roots[i] <= best_t && roots[i] < miss) {
+                best_t = roots[i];
+                best = static_cast<int>(first + i);
+            }
+        }
+    }
+    
+    t = best_t;
+    return best;
+}
+
+static void accumulate(float* __restrict dst, const float* __restrict src, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        dst[i] += src[i];
+    }
+}
+
+static void tonemap_rgb8(const float* __restrict src, size_t count, float scale, uint8_t* __restrict dst) {
+    for (size_t i = 0; i < count; i++) {
+        float v = sqrtf(scale * src[i]);
+        v = min_f(max_f(v, 0.0f), 0.999f);
+        dst[i] = static_cast<uint8_t>(static_cast<int>(256.0f * v));
+    }
+}
+
+}
@@ -0,0 +1,16 @@
+#if defined(__x86_64__)
+#define KERNEL_NAMESPACE kernels_sse42
+#include "kernels_impl.h"
+
+namespace kernels_sse42 {
+
+extern const SimdKernels table = {
+    Isa::SSE42,
+    ray_boxes,
+    ray_spheres,
+    accumulate,
+    tonemap_rgb8
+};
+
+}
+#endif
@@ -0,0 +1,16 @@
+#include "utils/allocation_counter.h"
+#include <atomic>
+
+namespace {
+
+std::atomic<size_t> allocations(0);
+
+}
+
+size_t heap_allocation_count() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void note_heap_allocation() {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+}
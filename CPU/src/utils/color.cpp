@@ -3,6 +3,16 @@
 #include <algorithm>
 
 void write_color(std::ostream& out, Color pixel_color, int samples_per_pixel) {
+    unsigned char rgb[3];
+    color_to_rgb8(pixel_color, samples_per_pixel, rgb);
+    
+    // Write the translated [0,255] value of each color component
+    out << static_cast<int>(rgb[0]) << ' '
+        << static_cast<int>(rgb[1]) << ' '
+        << static_cast<int>(rgb[2]) << '\n';
+}
+
+void color_to_rgb8(Color pixel_color, int samples_per_pixel, unsigned char rgb[3]) {
     float r = pixel_color.x;
     float g = pixel_color.y;
     float b = pixel_color.z;
@@ -13,8 +23,7 @@ void write_color(std::ostream& out, Color pixel_color, int samples_per_pixel) {
     g = sqrt(scale * g);
     b = sqrt(scale * b);
     
-    // Write the translated [0,255] value of each color component
-    out << static_cast<int>(256 * std::clamp(r, 0.0f, 0.999f)) << ' '
-        << static_cast<int>(256 * std::clamp(g, 0.0f, 0.999f)) << ' '
-        << static_cast<int>(256 * std::clamp(b, 0.0f, 0.999f)) << '\n';
-}
\ No newline at end of file
+    rgb[0] = static_cast<unsigned char>(256 * std::clamp(r, 0.0f, 0.999f));
+    rgb[1] = static_cast<unsigned char>(256 * std::clamp(g, 0.0f, 0.999f));
+    rgb[2] = static_cast<unsigned char>(256 * std::clamp(b, 0.0f, 0.999f));
+}
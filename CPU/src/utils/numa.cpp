@@ -0,0 +1,158 @@
+#include "utils/numa.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <linux/mempolicy.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// Parse a kernel CPU list such as "0-3,8-11"
+std::vector<int> parse_cpu_list(const std::string& text) {
+    std::vector<int> cpus;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t comma = text.find(',', pos);
+        std::string range = text.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+        int first, last;
+        if (sscanf(range.c_str(), "%d-%d", &first, &last) == 2) {
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } else if (sscanf(range.c_str(), "%d", &first) == 1) {
+            cpus.push_back(first);
+        }
+        if (comma == std::string::npos) {
+            break;
+        }
+        pos = comma + 1;
+    }
+    return cpus;
+}
+
+NumaTopology detect_topology() {
+    std::vector<int> allowed = current_thread_cpus();
+    
+    NumaTopology topology;
+    for (int id = 0; id < 1024; id++) {
+        std::ifstream file("/sys/devices/system/node/node" + std::to_string(id) + "/cpulist");
+        if (!file) {
+            continue;
+        }
+        std::string line;
+        std::getline(file, line);
+        
+        std::vector<int> cpus;
+        for (int cpu : parse_cpu_list(line)) {
+            if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+                cpus.push_back(cpu);
+            }
+        }
+        if (!cpus.empty()) {
+            topology.node_cpus.push_back(cpus);
+            topology.node_ids.push_back(id);
+        }
+    }
+    
+    if (topology.node_cpus.empty()) {
+        topology.node_cpus.push_back(allowed);
+        topology.node_ids.push_back(0);
+    }
+    return topology;
+}
+
+}
+
+int NumaTopology::cpu_count() const {
+    int count = 0;
+    for (const auto& cpus : node_cpus) {
+        count += static_cast<int>(cpus.size());
+    }
+    return count;
+}
+
+const NumaTopology& NumaTopology::get() {
+    static const NumaTopology topology = detect_topology();
+    return topology;
+}
+
+bool pin_current_thread(const std::vector<int>& cpus, int node) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        return false;
+    }
+    thread_numa_node = node;
+    return true;
+}
+
+std::vector<int> current_thread_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &set)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+    if (cpus.empty()) {
+        int count = std::max(1u, std::thread::hardware_concurrency());
+        for (int cpu = 0; cpu < count; cpu++) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+bool bind_memory_to_node(const void* address, size_t bytes, int node) {
+    const NumaTopology& topology = NumaTopology::get();
+    if (node < 0 || node >= topology.node_count()) {
+        return false;
+    }
+    
+    // mbind works on whole pages
+    uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(address) + page - 1) / page * page;
+    uintptr_t end = (reinterpret_cast<uintptr_t>(address) + bytes) / page * page;
+    if (end <= begin) {
+        return true;
+    }
+    
+    const int id = topology.node_ids[node];
+    const unsigned long bits = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(id / bits + 1, 0);
+    mask[id / bits] = 1ul << (id % bits);
+    return syscall(SYS_mbind, begin, end - begin, MPOL_BIND, mask.data(), mask.size() * bits + 1,
+                   MPOL_MF_MOVE) == 0;
+}
+
+void run_on_node(int node, const std::function<void()>& task) {
+    const NumaTopology& topology = NumaTopology::get();
+    std::exception_ptr error;
+    std::thread thread([&] {
+        try {
+            if (node >= 0 && node < topology.node_count()) {
+                pin_current_thread(topology.node_cpus[node], node);
+            }
+            task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+    });
+    thread.join();
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
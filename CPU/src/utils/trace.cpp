@@ -0,0 +1,128 @@
+#include "utils/trace.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+std::atomic<bool> Tracer::active(false);
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    int64_t begin_ns;
+    int64_t end_ns;
+    int tile_x;
+    int tile_y;
+};
+
+// One per thread that has recorded anything. Owned by the registry so the
+// events survive the thread.
+struct ThreadTrace {
+    int id;
+    std::string name;
+    std::vector<TraceEvent> events;
+};
+
+std::mutex registry_mutex;
+std::vector<std::unique_ptr<ThreadTrace>> registry;
+int64_t epoch_ns = 0;
+
+thread_local ThreadTrace* current_thread = nullptr;
+
+ThreadTrace& thread_trace() {
+    if (!current_thread) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        auto trace = std::make_unique<ThreadTrace>();
+        trace->id = static_cast<int>(registry.size());
+        trace->name = "thread " + std::to_string(trace->id);
+        trace->events.reserve(4096);
+        current_thread = trace.get();
+        registry.push_back(std::move(trace));
+    }
+    return *current_thread;
+}
+
+// Names are literals chosen in this program, but escape them anyway
+void write_string(std::ostream& out, const std::string& text) {
+    out << '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+}
+
+int64_t Tracer::now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::start() {
+    epoch_ns = now_ns();
+    active.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::set_thread_name(const std::string& name) {
+    if (enabled()) {
+        thread_trace().name = name;
+    }
+}
+
+void Tracer::record(const char* name, const char* category, int64_t begin_ns, int64_t end_ns,
+                    int tile_x, int tile_y) {
+    thread_trace().events.push_back({name, category, begin_ns, end_ns, tile_x, tile_y});
+}
+
+void Tracer::write(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot open trace file: " + path);
+    }
+    
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    
+    // Complete ("X") events in microseconds, plus one metadata event per thread
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"raytracer\"}}";
+    char number[64];
+    for (const auto& thread : registry) {
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread->id
+            << ",\"args\":{\"name\":";
+        write_string(out, thread->name);
+        out << "}}";
+        
+        for (const TraceEvent& event : thread->events) {
+            out << ",\n{\"name\":";
+            write_string(out, event.name);
+            out << ",\"cat\":";
+            write_string(out, event.category);
+            snprintf(number, sizeof(number), "%.3f", (event.begin_ns - epoch_ns) / 1000.0);
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->id << ",\"ts\":" << number;
+            snprintf(number, sizeof(number), "%.3f", (event.end_ns - event.begin_ns) / 1000.0);
+            out << ",\"dur\":" << number;
+            if (event.tile_x >= 0) {
+                out << ",\"args\":{\"x\":" << event.tile_x << ",\"y\":" << event.tile_y << "}";
+            }
+            out << "}";
+        }
+    }
+    out << "\n]}\n";
+    
+    if (!out) {
+        throw std::runtime_error("Failed writing trace file: " + path);
+    }
+}